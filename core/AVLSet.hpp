@@ -16,15 +16,139 @@
 // in your data structure.  Instead, you'll need to implement your AVL tree
 // using your own dynamically-allocated nodes, with pointers connecting them,
 // and with your own balancing algorithms used.
+//
+// The nodes are allocated from a NodePool owned by the AVLSet, so that
+// building a large tree doesn't make one allocation per element and
+// destroying a tree of trivially destructible elements doesn't have to
+// visit every node.  Copying a large tree, or destroying one whose
+// elements have destructors, divides the work among several threads.
 
 #ifndef AVLSET_HPP
 #define AVLSET_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "FrozenOrderedSet.hpp"
+#include "NodePool.hpp"
 #include "Set.hpp"
 
 
 
+namespace impl_
+{
+    // avlCompare() compares a and b in one step, returning a negative
+    // number if a < b, a positive one if b < a, and zero if they're equal.
+    // Strings (and anything else that can be viewed as a std::string_view)
+    // are compared with compare(), which looks at each character once;
+    // anything else is compared with < in both directions.
+    template <typename A, typename B>
+    int avlCompare(const A& a, const B& b)
+    {
+        if constexpr(std::is_convertible_v<const A&, std::string_view>
+                     && std::is_convertible_v<const B&, std::string_view>) {
+            return std::string_view{a}.compare(std::string_view{b});
+        }
+        else {
+            if(a < b) {
+                return -1;
+            }
+            else if(b < a) {
+                return 1;
+            }
+            else {
+                return 0;
+            }
+        }
+    }
+
+
+    // An AVLPathStack is a stack that remembers a path from the root
+    // of a tree downward.  A balanced tree is never deep enough to need
+    // more than the space built into the stack, so that no memory is
+    // allocated; an unbalanced one may be, so the stack can grow.
+    template <typename T>
+    class AVLPathStack
+    {
+    public:
+        AVLPathStack()
+            : items{inlineItems}, capacity{INLINE_CAPACITY}, count{0}
+        {
+        }
+
+        ~AVLPathStack() noexcept
+        {
+            if(items != inlineItems) {
+                delete[] items;
+            }
+        }
+
+        AVLPathStack(const AVLPathStack& s)
+            : AVLPathStack{}
+        {
+            for(unsigned int i = 0; i < s.count; i++) {
+                push(s.items[i]);
+            }
+        }
+
+        AVLPathStack& operator=(const AVLPathStack& s)
+        {
+            if(this != &s) {
+                count = 0;
+                for(unsigned int i = 0; i < s.count; i++) {
+                    push(s.items[i]);
+                }
+            }
+            return *this;
+        }
+
+        void push(const T& item)
+        {
+            if(count == capacity) {
+                T* larger = new T[capacity * 2];
+                std::copy(items, items + count, larger);
+                if(items != inlineItems) {
+                    delete[] items;
+                }
+                items = larger;
+                capacity *= 2;
+            }
+            items[count++] = item;
+        }
+
+        T pop() noexcept
+        {
+            return items[--count];
+        }
+
+        const T& top() const noexcept
+        {
+            return items[count - 1];
+        }
+
+        bool empty() const noexcept
+        {
+            return count == 0;
+        }
+
+    private:
+        static constexpr unsigned int INLINE_CAPACITY = 64;
+
+        T inlineItems[INLINE_CAPACITY];
+        T* items;
+        unsigned int capacity;
+        unsigned int count;
+    };
+}
+
+
 
 template <typename ElementType>
 class AVLSet : public Set<ElementType>
@@ -34,6 +158,13 @@ public:
     // ElementType and returns no value.
     using VisitFunction = std::function<void(const ElementType&)>;
 
+    // A const_iterator visits the elements of the set in ascending order.
+    // Elements can't be modified through one, since that could break the
+    // ordering of the tree, so iterator is the same type.  Adding to the
+    // set invalidates all of its iterators.
+    class const_iterator;
+    using iterator = const_iterator;
+
 public:
     // Initializes an AVLSet to be empty, with or without balancing.
     explicit AVLSet(bool shouldBalance = true);
@@ -55,6 +186,18 @@ public:
     AVLSet& operator=(AVLSet&& s) noexcept;
 
 
+    // buildFromSorted() returns an AVLSet containing the elements in the
+    // range [first, last), which should be in ascending order.  Adjacent
+    // duplicates are skipped.  The tree is built perfectly balanced in
+    // O(n) time, comparing only neighboring elements and never rotating,
+    // whether or not the new set will balance itself as more elements are
+    // added.  If the range turns out
+    // not to be sorted, its elements are added one at a time instead.
+    template <typename ForwardIterator>
+    static AVLSet buildFromSorted(
+        ForwardIterator first, ForwardIterator last, bool shouldBalance = true);
+
+
     // isImplemented() should be modified to return true if you've
     // decided to implement an AVLSet, false otherwise.
     virtual bool isImplemented() const noexcept override;
@@ -68,10 +211,20 @@ public:
 
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function always runs in O(log n) time when
-    // there are n elements in the AVL tree.
+    // there are n elements in the AVL tree, and compares the element to
+    // each node on its path only once.
     virtual bool contains(const ElementType& element) const override;
 
 
+    // containsKey() returns true if the set contains an element equivalent
+    // to the given key, which can be of some type other than ElementType
+    // (such as a std::string_view, when the elements are std::strings), so
+    // that looking it up doesn't require building an ElementType first.
+    // Keys and elements must be comparable with < in both directions.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept override;
 
@@ -81,6 +234,70 @@ public:
     int height() const;
 
 
+    // rank() returns the number of elements in the set that are less than
+    // the given one (which is its position in ascending order, if it's in
+    // the set).  It runs in O(log n) time, as do select(), lowerBound(),
+    // and upperBound(), since every node knows the size of its subtree.
+    unsigned int rank(const ElementType& element) const;
+
+
+    // select() returns the element at the given position in ascending
+    // order, counting from 0.  It throws a std::out_of_range if there's
+    // no such position.
+    const ElementType& select(unsigned int index) const;
+
+
+    // lowerBound() returns a pointer to the smallest element that is not
+    // less than the given one, and upperBound() to the smallest element
+    // that is greater than it.  Each returns nullptr if there's no such
+    // element.
+    const ElementType* lowerBound(const ElementType& element) const;
+    const ElementType* upperBound(const ElementType& element) const;
+
+
+    // rangeVisit() calls the given "visit" function, in ascending order,
+    // for each element that is at least lo and less than hi.  It runs in
+    // O(log n + k) time when it visits k elements, so, for example, all of
+    // the words starting with "pre" can be found by visiting the range
+    // from "pre" to "prf".
+    template <typename Visitor>
+    void rangeVisit(const ElementType& lo, const ElementType& hi, Visitor visit) const;
+
+
+    // unionWith() adds every element of the given set to this one,
+    // intersectWith() removes every element that isn't also in the given
+    // set, and differenceWith() removes every element that is.  Each one
+    // splits this tree around the elements of the other and joins the
+    // pieces back together, which takes O(m log(n/m + 1)) time when the
+    // sets have m and n elements (m <= n), and works on separate subtrees
+    // in parallel when both sets are large.  The join algorithms depend
+    // on both trees being balanced, so if either set doesn't balance
+    // itself, the work is done one element at a time instead.
+    void unionWith(const AVLSet& s);
+    void intersectWith(const AVLSet& s);
+    void differenceWith(const AVLSet& s);
+
+
+    // destroyAsync() empties the set right away, and destroys the elements
+    // it used to hold on another thread, so that, for example, the old
+    // copy of a dictionary that's been reloaded can be thrown away without
+    // holding up the thread that reloaded it.  The returned future becomes
+    // ready once they've all been destroyed.
+    std::future<void> destroyAsync();
+
+
+    // freeze() returns a read-only copy of the set, laid out for faster
+    // lookups.  (See FrozenOrderedSet.hpp for details.)
+    FrozenOrderedSet<ElementType> freeze() const;
+
+
+    // begin() and end() return iterators that visit the elements of the
+    // set in ascending order.  Advancing an iterator takes O(1) amortized
+    // time.
+    const_iterator begin() const;
+    const_iterator end() const;
+
+
     // preorder() calls the given "visit" function for each of the elements
     // in the set, in the order determined by a preorder traversal of the AVL
     // tree.
@@ -99,6 +316,19 @@ public:
     void postorder(VisitFunction visit) const;
 
 
+    // These versions of the traversals accept any kind of function (e.g.,
+    // a lambda expression) and call it directly, rather than through a
+    // std::function, so that it can be inlined into the traversal.
+    template <typename Visitor>
+    void preorder(Visitor visit) const;
+
+    template <typename Visitor>
+    void inorder(Visitor visit) const;
+
+    template <typename Visitor>
+    void postorder(Visitor visit) const;
+
+
 private:
     // You'll no doubt want to add member variables and "helper" member
     // functions here.
@@ -107,34 +337,56 @@ private:
         struct Node *left;
         struct Node *right;
         int h;
+        int count;
         Node(ElementType element) { 
             value = element;
             left = NULL;
             right = NULL;
             h = 0;
+            count = 1;
         }
         Node(ElementType element, Node *l, Node *r) {
             value = element;
             left = l;
             right = r;
             h = 0;
+            count = 1;
         }
     };
     bool balancing;
     int sz;
     Node *root;
-    void makeEmpty(Node *r);
-    Node* add_helper(const ElementType& element, Node *r);
-    bool contains_helper(const ElementType& element, Node *r) const;
+    NodePool<Node> pool;
+    static void makeEmpty(Node *r, int forks) noexcept;
+    void clear() noexcept;
     int max(int x, int y) const;
-    Node* deepCopy(Node *r);
-    void preorder_helper(Node* r, VisitFunction visit) const;
-    void inorder_helper(Node* r, VisitFunction visit) const;
-    void postorder_helper(Node* r, VisitFunction visit) const;
+    static Node* deepCopy(const Node *r, NodePool<Node>& p, int forks = 0);
+    template <typename ForwardIterator>
+    Node* buildBalanced(ForwardIterator& next, ForwardIterator last, int count);
+    template <typename Visitor>
+    void preorder_helper(Visitor& visit) const;
+    template <typename Visitor>
+    void inorder_helper(Visitor& visit) const;
+    template <typename Visitor>
+    void postorder_helper(Visitor& visit) const;
     Node* rr_rotation(Node* n);
     Node* lr_rotation(Node* n);
     int difference(Node* n);
     int hhh(Node* n);
+    static int countOf(const Node* n);
+    void update(Node* n);
+    Node* join(Node* l, Node* k, Node* r);
+    Node* joinRight(Node* l, Node* k, Node* r);
+    Node* joinLeft(Node* l, Node* k, Node* r);
+    Node* join2(Node* l, Node* r);
+    Node* splitLast(Node* t, Node*& last);
+    void split(Node* t, const ElementType& key, Node*& l, Node*& found, Node*& r);
+    void destroyTree(Node* t, NodePool<Node>& p);
+    Node* unionTrees(Node* t1, const Node* t2, NodePool<Node>& p, int forks);
+    Node* intersectTrees(Node* t1, const Node* t2, NodePool<Node>& p, int forks);
+    Node* differenceTrees(Node* t1, const Node* t2, NodePool<Node>& p, int forks);
+    static int forkBudget(int elementCount) noexcept;
+    static constexpr int PARALLEL_THRESHOLD = 1 << 14;
 };
 typedef struct Node Node;
 
@@ -164,6 +416,8 @@ typename AVLSet<ElementType>::Node* AVLSet<ElementType>::rr_rotation(Node* n) {
 
     n->h = max(hhh(n->left),hhh(n->right))+1;
     x->h = max(hhh(x->left),hhh(x->right))+1;
+    n->count = countOf(n->left) + countOf(n->right) + 1;
+    x->count = countOf(x->left) + countOf(x->right) + 1;
 
     return x;
 }
@@ -179,6 +433,16 @@ int AVLSet<ElementType>::hhh(Node* n) {
     }
 }
 
+template <typename ElementType>
+int AVLSet<ElementType>::countOf(const Node* n) {
+    if(n == nullptr) {
+        return 0;
+    }
+    else {
+        return n->count;
+    }
+}
+
 template <typename ElementType>
 typename AVLSet<ElementType>::Node* AVLSet<ElementType>::lr_rotation(Node* n) {
     Node* y = n->right;
@@ -188,114 +452,501 @@ typename AVLSet<ElementType>::Node* AVLSet<ElementType>::lr_rotation(Node* n) {
 
     n->h = max(hhh(n->left),hhh(n->right))+1;
     y->h = max(hhh(y->left),hhh(y->right))+1;
+    n->count = countOf(n->left) + countOf(n->right) + 1;
+    y->count = countOf(y->left) + countOf(y->right) + 1;
 
     return y;
 }
 
 
+// deepCopy() copies a tree into the given pool.  A large enough tree has
+// its left subtree copied on another thread, into a pool of its own that
+// the given pool then absorbs, while its right subtree is copied on this
+// one; forks limits how many levels of this can happen.  Below that, the
+// copy is made iteratively, copying each node before its children and
+// keeping the ones still to be copied on a stack, so that even a very
+// unbalanced tree can be copied without deep recursion.
 template <typename ElementType>
-typename AVLSet<ElementType>::Node* AVLSet<ElementType>::deepCopy(Node *r) {
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::deepCopy(const Node *r, NodePool<Node>& p, int forks) {
     if(r == nullptr) {
         return nullptr;
     }
-    else {
-        return new Node(r->value, deepCopy(r->left), deepCopy(r->right));
+
+    if(forks > 0 && countOf(r) >= PARALLEL_THRESHOLD) {
+        NodePool<Node> local;
+        std::future<Node*> left = std::async(std::launch::async,
+            [&]() { return deepCopy(r->left, local, forks - 1); });
+        Node* right = deepCopy(r->right, p, forks - 1);
+        Node* n = p.create(r->value, left.get(), right);
+        p.absorb(std::move(local));
+        n->h = r->h;
+        n->count = r->count;
+        return n;
+    }
+
+    struct Pending {
+        const Node* source;
+        Node** link;
+    };
+
+    Node* copy = nullptr;
+    impl_::AVLPathStack<Pending> pending;
+    pending.push(Pending{r, &copy});
+    while(!pending.empty()) {
+        Pending next = pending.pop();
+        Node* n = p.create(next.source->value, nullptr, nullptr);
+        n->h = next.source->h;
+        n->count = next.source->count;
+        *next.link = n;
+        if(next.source->right != nullptr) {
+            pending.push(Pending{next.source->right, &n->right});
+        }
+        if(next.source->left != nullptr) {
+            pending.push(Pending{next.source->left, &n->left});
+        }
     }
+    return copy;
 }
 
+// buildBalanced() builds a tree out of the next count distinct elements,
+// consuming them in order: first the left half, then the root, then the
+// right half.  The halves' sizes differ by at most one, so the heights of
+// sibling subtrees do, too.
 template <typename ElementType>
-void AVLSet<ElementType>::preorder_helper(Node* r, VisitFunction visit) const
+template <typename ForwardIterator>
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::buildBalanced(
+    ForwardIterator& next, ForwardIterator last, int count)
 {
-    if(r != nullptr) {
-        visit(r->value);
-        preorder_helper(r->left, visit);
-        preorder_helper(r->right, visit);
+    if(count == 0) {
+        return nullptr;
+    }
+
+    int leftCount = (count - 1) / 2;
+    Node* left = buildBalanced(next, last, leftCount);
+    Node* n = pool.create(*next, left, nullptr);
+    ++next;
+    while(next != last && impl_::avlCompare(n->value, *next) == 0) {
+        ++next;
     }
+    n->right = buildBalanced(next, last, count - 1 - leftCount);
+    n->h = max(hhh(n->left), hhh(n->right)) + 1;
+    n->count = count;
+    return n;
 }
 
+// The set operations are built out of two primitives.  join() takes two
+// trees and a node whose element lies between them, and combines them into
+// one balanced tree, walking down the taller one's spine to find a subtree
+// of about the same height as the shorter one.  split() divides a tree
+// into the elements less than a key, the node holding the key (if any),
+// and the elements greater than it.  Neither allocates or frees any nodes,
+// and both keep every node's height and size up to date.
+
 template <typename ElementType>
-void AVLSet<ElementType>::inorder_helper(Node* r, VisitFunction visit) const
-{
-    if(r != nullptr) {
-        inorder_helper(r->left, visit);
-        visit(r->value);
-        inorder_helper(r->right, visit);
+void AVLSet<ElementType>::update(Node* n) {
+    n->h = max(hhh(n->left), hhh(n->right)) + 1;
+    n->count = countOf(n->left) + countOf(n->right) + 1;
+}
+
+template <typename ElementType>
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::join(Node* l, Node* k, Node* r) {
+    if(hhh(l) > hhh(r) + 1) {
+        return joinRight(l, k, r);
+    }
+    else if(hhh(r) > hhh(l) + 1) {
+        return joinLeft(l, k, r);
+    }
+    else {
+        k->left = l;
+        k->right = r;
+        update(k);
+        return k;
     }
 }
 
 template <typename ElementType>
-void AVLSet<ElementType>::postorder_helper(Node* r, VisitFunction visit) const
-{
-    if(r != nullptr) {
-        postorder_helper(r->left, visit);
-        postorder_helper(r->right, visit);
-        visit(r->value);
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::joinRight(Node* l, Node* k, Node* r) {
+    Node* c = l->right;
+    if(hhh(c) <= hhh(r) + 1) {
+        k->left = c;
+        k->right = r;
+        update(k);
+        if(hhh(k) <= hhh(l->left) + 1) {
+            l->right = k;
+            update(l);
+            return l;
+        }
+        else {
+            l->right = rr_rotation(k);
+            return lr_rotation(l);
+        }
+    }
+    else {
+        Node* t = joinRight(c, k, r);
+        l->right = t;
+        update(l);
+        if(hhh(t) <= hhh(l->left) + 1) {
+            return l;
+        }
+        else {
+            return lr_rotation(l);
+        }
     }
 }
 
+template <typename ElementType>
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::joinLeft(Node* l, Node* k, Node* r) {
+    Node* c = r->left;
+    if(hhh(c) <= hhh(l) + 1) {
+        k->left = l;
+        k->right = c;
+        update(k);
+        if(hhh(k) <= hhh(r->right) + 1) {
+            r->left = k;
+            update(r);
+            return r;
+        }
+        else {
+            r->left = lr_rotation(k);
+            return rr_rotation(r);
+        }
+    }
+    else {
+        Node* t = joinLeft(l, k, c);
+        r->left = t;
+        update(r);
+        if(hhh(t) <= hhh(r->right) + 1) {
+            return r;
+        }
+        else {
+            return rr_rotation(r);
+        }
+    }
+}
 
+// join2() joins two trees without a node between them, by taking the
+// largest node out of the left one and using it as the middle.
 template <typename ElementType>
-void AVLSet<ElementType>::makeEmpty(Node *r) {
-    if(r != nullptr) {
-        makeEmpty(r->left);
-        makeEmpty(r->right);
-        delete r;
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::join2(Node* l, Node* r) {
+    if(l == nullptr) {
+        return r;
     }
-    
+    Node* last;
+    Node* rest = splitLast(l, last);
+    return join(rest, last, r);
 }
 
 template <typename ElementType>
-typename AVLSet<ElementType>::Node* AVLSet<ElementType>::add_helper(const ElementType& element, Node *n) { 
-    if(n == nullptr) {
-        n = new Node(element);
-        sz += 1;
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::splitLast(Node* t, Node*& last) {
+    if(t->right == nullptr) {
+        last = t;
+        Node* rest = t->left;
+        t->left = nullptr;
+        return rest;
+    }
+    Node* rest = splitLast(t->right, last);
+    return join(t->left, t, rest);
+}
+
+template <typename ElementType>
+void AVLSet<ElementType>::split(Node* t, const ElementType& key, Node*& l, Node*& found, Node*& r) {
+    if(t == nullptr) {
+        l = nullptr;
+        found = nullptr;
+        r = nullptr;
+        return;
+    }
+
+    int c = impl_::avlCompare(key, t->value);
+    if(c == 0) {
+        l = t->left;
+        r = t->right;
+        found = t;
+        t->left = nullptr;
+        t->right = nullptr;
+        update(t);
+    }
+    else if(c < 0) {
+        Node* between;
+        split(t->left, key, l, found, between);
+        r = join(between, t, t->right);
+    }
+    else {
+        Node* between;
+        split(t->right, key, between, found, r);
+        l = join(t->left, t, between);
+    }
+}
+
+template <typename ElementType>
+void AVLSet<ElementType>::destroyTree(Node* t, NodePool<Node>& p) {
+    if(t != nullptr) {
+        destroyTree(t->left, p);
+        destroyTree(t->right, p);
+        p.destroy(t);
+    }
+}
+
+
+// Each set operation splits t1 around the element at the root of t2, then
+// recurses on the two halves of each.  When both halves are large enough
+// to be worth it, the left halves are handled by another thread, which
+// creates and frees nodes using a NodePool of its own; the main pool
+// absorbs it once the thread is done.  forks limits how many levels of
+// the recursion can start new threads.
+
+template <typename ElementType>
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::unionTrees(
+    Node* t1, const Node* t2, NodePool<Node>& p, int forks)
+{
+    if(t2 == nullptr) {
+        return t1;
+    }
+    if(t1 == nullptr) {
+        return deepCopy(t2, p, 0);
+    }
+
+    bool parallel = forks > 0 && countOf(t1) + countOf(t2) >= PARALLEL_THRESHOLD;
+    Node* l1;
+    Node* found;
+    Node* r1;
+    split(t1, t2->value, l1, found, r1);
+
+    Node* l;
+    Node* r;
+    if(parallel) {
+        NodePool<Node> local;
+        std::future<Node*> left = std::async(std::launch::async,
+            [&]() { return unionTrees(l1, t2->left, local, forks - 1); });
+        r = unionTrees(r1, t2->right, p, forks - 1);
+        l = left.get();
+        p.absorb(std::move(local));
+    }
+    else {
+        l = unionTrees(l1, t2->left, p, 0);
+        r = unionTrees(r1, t2->right, p, 0);
+    }
+
+    if(found == nullptr) {
+        found = p.create(t2->value);
+    }
+    return join(l, found, r);
+}
+
+template <typename ElementType>
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::intersectTrees(
+    Node* t1, const Node* t2, NodePool<Node>& p, int forks)
+{
+    if(t1 == nullptr) {
+        return nullptr;
+    }
+    if(t2 == nullptr) {
+        destroyTree(t1, p);
+        return nullptr;
+    }
+
+    bool parallel = forks > 0 && countOf(t1) + countOf(t2) >= PARALLEL_THRESHOLD;
+    Node* l1;
+    Node* found;
+    Node* r1;
+    split(t1, t2->value, l1, found, r1);
+
+    Node* l;
+    Node* r;
+    if(parallel) {
+        NodePool<Node> local;
+        std::future<Node*> left = std::async(std::launch::async,
+            [&]() { return intersectTrees(l1, t2->left, local, forks - 1); });
+        r = intersectTrees(r1, t2->right, p, forks - 1);
+        l = left.get();
+        p.absorb(std::move(local));
+    }
+    else {
+        l = intersectTrees(l1, t2->left, p, 0);
+        r = intersectTrees(r1, t2->right, p, 0);
+    }
+
+    if(found != nullptr) {
+        return join(l, found, r);
+    }
+    else {
+        return join2(l, r);
+    }
+}
+
+template <typename ElementType>
+typename AVLSet<ElementType>::Node* AVLSet<ElementType>::differenceTrees(
+    Node* t1, const Node* t2, NodePool<Node>& p, int forks)
+{
+    if(t1 == nullptr || t2 == nullptr) {
+        return t1;
     }
-    else if(n->value > element) {
-        n->left = add_helper(element, n->left);
+
+    bool parallel = forks > 0 && countOf(t1) + countOf(t2) >= PARALLEL_THRESHOLD;
+    Node* l1;
+    Node* found;
+    Node* r1;
+    split(t1, t2->value, l1, found, r1);
+
+    Node* l;
+    Node* r;
+    if(parallel) {
+        NodePool<Node> local;
+        std::future<Node*> left = std::async(std::launch::async,
+            [&]() { return differenceTrees(l1, t2->left, local, forks - 1); });
+        r = differenceTrees(r1, t2->right, p, forks - 1);
+        l = left.get();
+        p.absorb(std::move(local));
     }
     else {
-        n->right = add_helper(element, n->right);
+        l = differenceTrees(l1, t2->left, p, 0);
+        r = differenceTrees(r1, t2->right, p, 0);
+    }
+
+    if(found != nullptr) {
+        p.destroy(found);
+    }
+    return join2(l, r);
+}
+
+// forkBudget() allows enough levels of forking to give every hardware
+// thread some work, plus one more so that uneven splits even out.  Work on
+// fewer than PARALLEL_THRESHOLD elements never forks, so it gets a budget
+// of 0 without asking how many hardware threads there are, and the answer
+// is only asked for once, since it can take a system call.
+template <typename ElementType>
+int AVLSet<ElementType>::forkBudget(int elementCount) noexcept
+{
+    if(elementCount < PARALLEL_THRESHOLD) {
+        return 0;
     }
-    
-    int l = n->left? n->left->h : -1;
-    int r = n->right? n->right->h : -1;
-    n->h = max(l + 1, r + 1);
-    
 
-    if(balancing == true) {
-        int b = difference(n);
-        if(b > 1 && element < n->left->value) {
-            return rr_rotation(n);
+    static const int levels = []() {
+        unsigned int threads = std::thread::hardware_concurrency();
+        int l = 1;
+        while((1u << (l - 1)) < threads) {
+            l++;
         }
-        if(b < -1 && element > n->right->value) {
-            return lr_rotation(n);
+        return l;
+    }();
+    return levels;
+}
+
+
+// The traversals are iterative, keeping the nodes they'll come back to on
+// a stack, so that they don't recurse as deeply as the tree is tall.
+
+template <typename ElementType>
+template <typename Visitor>
+void AVLSet<ElementType>::preorder_helper(Visitor& visit) const
+{
+    impl_::AVLPathStack<const Node*> path;
+    if(root != nullptr) {
+        path.push(root);
+    }
+    while(!path.empty()) {
+        const Node* n = path.pop();
+        visit(n->value);
+        if(n->right != nullptr) {
+            path.push(n->right);
         }
-        if(b > 1 && element > n->left->value) {
-            n->left = lr_rotation(n->left);
-            return rr_rotation(n);
+        if(n->left != nullptr) {
+            path.push(n->left);
         }
-        if(b < -1 && element < n->right->value) {
-            n->right = rr_rotation(n->right);
-            return lr_rotation(n);
+    }
+}
+
+template <typename ElementType>
+template <typename Visitor>
+void AVLSet<ElementType>::inorder_helper(Visitor& visit) const
+{
+    impl_::AVLPathStack<const Node*> path;
+    const Node* n = root;
+    while(n != nullptr || !path.empty()) {
+        for(; n != nullptr; n = n->left) {
+            path.push(n);
         }
+        n = path.pop();
+        visit(n->value);
+        n = n->right;
     }
-    return n;
 }
 
+// postorder_helper() visits a node once it comes back up from its right
+// subtree, which it recognizes because that subtree's root was the last
+// node visited.
 template <typename ElementType>
-bool AVLSet<ElementType>::contains_helper(const ElementType& element, Node *r) const {
-    if(r == nullptr) {
-        return false;
+template <typename Visitor>
+void AVLSet<ElementType>::postorder_helper(Visitor& visit) const
+{
+    impl_::AVLPathStack<const Node*> path;
+    const Node* n = root;
+    const Node* lastVisited = nullptr;
+    while(n != nullptr || !path.empty()) {
+        for(; n != nullptr; n = n->left) {
+            path.push(n);
+        }
+        const Node* top = path.top();
+        if(top->right != nullptr && top->right != lastVisited) {
+            n = top->right;
+        }
+        else {
+            visit(top->value);
+            lastVisited = path.pop();
+        }
     }
-    else if(r->value == element) {
-        return true;
+}
+
+
+// makeEmpty() runs the destructors of every node in a subtree, leaving
+// their memory to be given back by the pool.  Like deepCopy(), it hands the
+// left subtrees of large enough trees to other threads.  Below that, it
+// rotates each node's left subtree up until the node has no left child,
+// then destroys it and moves on to its right child, which takes O(n) time
+// without any recursion or stack at all.
+template <typename ElementType>
+void AVLSet<ElementType>::makeEmpty(Node *r, int forks) noexcept {
+    if(r != nullptr && forks > 0 && countOf(r) >= PARALLEL_THRESHOLD) {
+        Node* l = r->left;
+        std::future<void> left;
+        try {
+            left = std::async(std::launch::async, [=]() { makeEmpty(l, forks - 1); });
+        }
+        catch(...) {
+            makeEmpty(r, 0);
+            return;
+        }
+        makeEmpty(r->right, forks - 1);
+        r->~Node();
+        left.wait();
+        return;
     }
-    else if(element < r->value) {
-        return contains_helper(element, r->left);
+
+    while(r != nullptr) {
+        if(r->left != nullptr) {
+            Node* l = r->left;
+            r->left = l->right;
+            l->right = r;
+            r = l;
+        }
+        else {
+            Node* next = r->right;
+            r->~Node();
+            r = next;
+        }
     }
-    else {
-        return contains_helper(element, r->right);
+}
+
+// clear() disposes of the whole tree.  When the nodes are trivially
+// destructible, the tree doesn't need to be walked at all.
+template <typename ElementType>
+void AVLSet<ElementType>::clear() noexcept {
+    if(!NodePool<Node>::isTriviallyDestructible) {
+        makeEmpty(root, forkBudget(sz));
     }
+    pool.release();
+    root = nullptr;
+    sz = 0;
 }
 
 template <typename ElementType>
@@ -325,16 +976,14 @@ AVLSet<ElementType>::AVLSet(bool shouldBalance)
 template <typename ElementType>
 AVLSet<ElementType>::~AVLSet() noexcept
 {
-    makeEmpty(root);
-    root = nullptr;
-    sz = 0;
+    clear();
 }
 
 
 template <typename ElementType>
 AVLSet<ElementType>::AVLSet(const AVLSet& s)
 {   
-    root = deepCopy(s.root);
+    root = deepCopy(s.root, pool, forkBudget(s.sz));
     balancing = s.balancing;
     sz = s.sz;
 }
@@ -344,9 +993,12 @@ template <typename ElementType>
 AVLSet<ElementType>::AVLSet(AVLSet&& s) noexcept
 {   
     root = nullptr;
+    balancing = true;
+    sz = 0;
     std::swap(root, s.root); 
     std::swap(balancing, s.balancing);
     std::swap(sz, s.sz);
+    std::swap(pool, s.pool);
 }
 
 
@@ -354,8 +1006,8 @@ template <typename ElementType>
 AVLSet<ElementType>& AVLSet<ElementType>::operator=(const AVLSet& s)
 {
     if(this != &s) {
-        makeEmpty(root);
-        root = deepCopy(s.root);
+        clear();
+        root = deepCopy(s.root, pool, forkBudget(s.sz));
         sz = s.sz;
         balancing = s.balancing;
     }
@@ -367,16 +1019,52 @@ template <typename ElementType>
 AVLSet<ElementType>& AVLSet<ElementType>::operator=(AVLSet&& s) noexcept
 {
     if(this != &s) {
-        makeEmpty(root);
         std::swap(root, s.root);
-        s.root = nullptr;
-        sz = s.sz;
-        balancing = s.balancing;
+        std::swap(sz, s.sz);
+        std::swap(balancing, s.balancing);
+        std::swap(pool, s.pool);
     }
     return *this;
 }
 
 
+template <typename ElementType>
+template <typename ForwardIterator>
+AVLSet<ElementType> AVLSet<ElementType>::buildFromSorted(
+    ForwardIterator first, ForwardIterator last, bool shouldBalance)
+{
+    AVLSet s{shouldBalance};
+
+    int count = 0;
+    bool sorted = true;
+    if(first != last) {
+        count = 1;
+        ForwardIterator previous = first;
+        for(ForwardIterator i = std::next(first); i != last; previous = i, ++i) {
+            int c = impl_::avlCompare(*previous, *i);
+            if(c > 0) {
+                sorted = false;
+                break;
+            }
+            else if(c < 0) {
+                count++;
+            }
+        }
+    }
+
+    if(sorted) {
+        s.root = s.buildBalanced(first, last, count);
+        s.sz = count;
+    }
+    else {
+        for(; first != last; ++first) {
+            s.add(*first);
+        }
+    }
+    return s;
+}
+
+
 template <typename ElementType>
 bool AVLSet<ElementType>::isImplemented() const noexcept
 {
@@ -384,19 +1072,89 @@ bool AVLSet<ElementType>::isImplemented() const noexcept
 }
 
 
+// add() walks down the tree once, remembering the links it followed, and
+// stops right away if it finds the element.  Otherwise, it hangs a new node
+// at the bottom and walks back up, adding one to the size of every subtree
+// along the way.  Heights are updated only until it finds a node whose
+// height didn't change or one that needed rotating (since a rotation after
+// an insertion restores the subtree's original height); no height above
+// that point can have changed.
 template <typename ElementType>
 void AVLSet<ElementType>::add(const ElementType& element)
-{   
-    if(AVLSet<ElementType>::contains(element) == false) {
-        root = add_helper(element, root);
+{
+    impl_::AVLPathStack<Node**> path;
+    Node** link = &root;
+    while(*link != nullptr) {
+        int c = impl_::avlCompare(element, (*link)->value);
+        if(c == 0) {
+            return;
+        }
+        path.push(link);
+        link = c < 0 ? &(*link)->left : &(*link)->right;
+    }
+
+    *link = pool.create(element);
+    sz += 1;
+
+    bool settled = false;
+    while(!path.empty()) {
+        link = path.pop();
+        Node* n = *link;
+        n->count += 1;
+        if(settled) {
+            continue;
+        }
+
+        int oldHeight = n->h;
+        n->h = max(hhh(n->left), hhh(n->right)) + 1;
+
+        if(balancing == true) {
+            int b = difference(n);
+            if(b > 1) {
+                if(difference(n->left) < 0) {
+                    n->left = lr_rotation(n->left);
+                }
+                *link = rr_rotation(n);
+                settled = true;
+                continue;
+            }
+            if(b < -1) {
+                if(difference(n->right) > 0) {
+                    n->right = rr_rotation(n->right);
+                }
+                *link = lr_rotation(n);
+                settled = true;
+                continue;
+            }
+        }
+
+        if(n->h == oldHeight) {
+            settled = true;
+        }
     }
 }
 
 
 template <typename ElementType>
 bool AVLSet<ElementType>::contains(const ElementType& element) const
-{   
-    return contains_helper(element, root);
+{
+    return containsKey(element);
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool AVLSet<ElementType>::containsKey(const Key& key) const
+{
+    Node* n = root;
+    while(n != nullptr) {
+        int c = impl_::avlCompare(key, n->value);
+        if(c == 0) {
+            return true;
+        }
+        n = c < 0 ? n->left : n->right;
+    }
+    return false;
 }
 
 
@@ -419,27 +1177,393 @@ int AVLSet<ElementType>::height() const
 }
 
 
+template <typename ElementType>
+unsigned int AVLSet<ElementType>::rank(const ElementType& element) const
+{
+    unsigned int r = 0;
+    Node* n = root;
+    while(n != nullptr) {
+        int c = impl_::avlCompare(element, n->value);
+        if(c == 0) {
+            return r + countOf(n->left);
+        }
+        else if(c < 0) {
+            n = n->left;
+        }
+        else {
+            r += countOf(n->left) + 1;
+            n = n->right;
+        }
+    }
+    return r;
+}
+
+
+template <typename ElementType>
+const ElementType& AVLSet<ElementType>::select(unsigned int index) const
+{
+    if(index >= static_cast<unsigned int>(sz)) {
+        throw std::out_of_range{"AVLSet::select(): index is out of range"};
+    }
+
+    Node* n = root;
+    while(true) {
+        unsigned int leftCount = countOf(n->left);
+        if(index < leftCount) {
+            n = n->left;
+        }
+        else if(index == leftCount) {
+            return n->value;
+        }
+        else {
+            index -= leftCount + 1;
+            n = n->right;
+        }
+    }
+}
+
+
+template <typename ElementType>
+const ElementType* AVLSet<ElementType>::lowerBound(const ElementType& element) const
+{
+    const ElementType* found = nullptr;
+    Node* n = root;
+    while(n != nullptr) {
+        if(impl_::avlCompare(n->value, element) >= 0) {
+            found = &n->value;
+            n = n->left;
+        }
+        else {
+            n = n->right;
+        }
+    }
+    return found;
+}
+
+
+template <typename ElementType>
+const ElementType* AVLSet<ElementType>::upperBound(const ElementType& element) const
+{
+    const ElementType* found = nullptr;
+    Node* n = root;
+    while(n != nullptr) {
+        if(impl_::avlCompare(n->value, element) > 0) {
+            found = &n->value;
+            n = n->left;
+        }
+        else {
+            n = n->right;
+        }
+    }
+    return found;
+}
+
+
+// rangeVisit() first walks down to lo, stacking up the nodes that aren't
+// less than it; those are exactly the ancestors an inorder traversal
+// starting at lo would still have to come back to.  From there, it's an
+// ordinary iterative inorder traversal that stops when it reaches hi.
+template <typename ElementType>
+template <typename Visitor>
+void AVLSet<ElementType>::rangeVisit(const ElementType& lo, const ElementType& hi, Visitor visit) const
+{
+    impl_::AVLPathStack<Node*> path;
+    Node* n = root;
+    while(n != nullptr) {
+        if(impl_::avlCompare(n->value, lo) >= 0) {
+            path.push(n);
+            n = n->left;
+        }
+        else {
+            n = n->right;
+        }
+    }
+
+    while(!path.empty()) {
+        n = path.pop();
+        if(impl_::avlCompare(n->value, hi) >= 0) {
+            return;
+        }
+        visit(n->value);
+        for(n = n->right; n != nullptr; n = n->left) {
+            path.push(n);
+        }
+    }
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::unionWith(const AVLSet& s)
+{
+    if(this == &s) {
+        return;
+    }
+    if(!balancing || !s.balancing) {
+        for(const ElementType& element : s) {
+            add(element);
+        }
+        return;
+    }
+    root = unionTrees(root, s.root, pool, forkBudget(countOf(root) + countOf(s.root)));
+    sz = countOf(root);
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::intersectWith(const AVLSet& s)
+{
+    if(this == &s) {
+        return;
+    }
+    if(!balancing || !s.balancing) {
+        std::vector<ElementType> kept;
+        for(const ElementType& element : *this) {
+            if(s.contains(element)) {
+                kept.push_back(element);
+            }
+        }
+        *this = buildFromSorted(kept.begin(), kept.end(), balancing);
+        return;
+    }
+    root = intersectTrees(root, s.root, pool, forkBudget(countOf(root) + countOf(s.root)));
+    sz = countOf(root);
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::differenceWith(const AVLSet& s)
+{
+    if(!balancing || !s.balancing || this == &s) {
+        std::vector<ElementType> kept;
+        if(this != &s) {
+            for(const ElementType& element : *this) {
+                if(!s.contains(element)) {
+                    kept.push_back(element);
+                }
+            }
+        }
+        *this = buildFromSorted(kept.begin(), kept.end(), balancing);
+        return;
+    }
+    root = differenceTrees(root, s.root, pool, forkBudget(countOf(root) + countOf(s.root)));
+    sz = countOf(root);
+}
+
+
+template <typename ElementType>
+std::future<void> AVLSet<ElementType>::destroyAsync()
+{
+    AVLSet old{balancing};
+    std::swap(root, old.root);
+    std::swap(sz, old.sz);
+    std::swap(pool, old.pool);
+    return std::async(std::launch::async, [old = std::move(old)]() mutable { old.clear(); });
+}
+
+
+template <typename ElementType>
+FrozenOrderedSet<ElementType> AVLSet<ElementType>::freeze() const
+{
+    return FrozenOrderedSet<ElementType>{begin(), end()};
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::begin() const
+{
+    return const_iterator{root};
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::end() const
+{
+    return const_iterator{};
+}
+
+
 template <typename ElementType>
 void AVLSet<ElementType>::preorder(VisitFunction visit) const
 {
-    preorder_helper(root, visit);
+    preorder_helper(visit);
 }
 
 
 template <typename ElementType>
 void AVLSet<ElementType>::inorder(VisitFunction visit) const
 {
-    inorder_helper(root, visit);
+    inorder_helper(visit);
 }
 
 
 template <typename ElementType>
 void AVLSet<ElementType>::postorder(VisitFunction visit) const
 {
-    postorder_helper(root, visit);
+    postorder_helper(visit);
+}
+
+
+template <typename ElementType>
+template <typename Visitor>
+void AVLSet<ElementType>::preorder(Visitor visit) const
+{
+    preorder_helper(visit);
+}
+
+
+template <typename ElementType>
+template <typename Visitor>
+void AVLSet<ElementType>::inorder(Visitor visit) const
+{
+    inorder_helper(visit);
+}
+
+
+template <typename ElementType>
+template <typename Visitor>
+void AVLSet<ElementType>::postorder(Visitor visit) const
+{
+    postorder_helper(visit);
 }
 
 
 
+// A const_iterator keeps a stack of the nodes on the path from the root to
+// its current node that it hasn't yet visited (including the current node,
+// which is on top).  Advancing pops the current node and pushes the path
+// down to the leftmost node in its right subtree, so a walk through the
+// whole set takes O(n) time, however the tree is shaped.  The stack is
+// never deeper than the tree is tall, so it's allocated with that many
+// entries when the iterator is created, and a copy copies only the entries
+// in use.  The end iterator has an empty stack.
+
+template <typename ElementType>
+class AVLSet<ElementType>::const_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ElementType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ElementType*;
+    using reference = const ElementType&;
+
+public:
+    const_iterator() noexcept = default;
+
+    ~const_iterator() noexcept
+    {
+        delete[] path;
+    }
+
+    const_iterator(const const_iterator& i)
+        : path{i.capacity == 0 ? nullptr : new const Node*[i.capacity]},
+          count{i.count}, capacity{i.capacity}
+    {
+        std::copy(i.path, i.path + i.count, path);
+    }
+
+    const_iterator(const_iterator&& i) noexcept
+    {
+        swap(i);
+    }
+
+    const_iterator& operator=(const const_iterator& i)
+    {
+        if(this != &i) {
+            const_iterator copy{i};
+            swap(copy);
+        }
+        return *this;
+    }
+
+    const_iterator& operator=(const_iterator&& i) noexcept
+    {
+        swap(i);
+        return *this;
+    }
+
+    reference operator*() const
+    {
+        return path[count - 1]->value;
+    }
+
+    pointer operator->() const
+    {
+        return &path[count - 1]->value;
+    }
+
+    const_iterator& operator++()
+    {
+        count--;
+        pushLeftPath(path[count]->right);
+        return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+        const_iterator old{*this};
+        ++*this;
+        return old;
+    }
+
+    bool operator==(const const_iterator& i) const noexcept
+    {
+        if(count == 0 || i.count == 0) {
+            return count == 0 && i.count == 0;
+        }
+        return path[count - 1] == i.path[i.count - 1];
+    }
+
+    bool operator!=(const const_iterator& i) const noexcept
+    {
+        return !(*this == i);
+    }
+
+private:
+    friend class AVLSet;
+
+    explicit const_iterator(const Node* root)
+    {
+        if(root != nullptr) {
+            capacity = static_cast<unsigned int>(root->h) + 1;
+            path = new const Node*[capacity];
+            pushLeftPath(root);
+        }
+    }
+
+    void swap(const_iterator& i) noexcept
+    {
+        std::swap(path, i.path);
+        std::swap(count, i.count);
+        std::swap(capacity, i.capacity);
+    }
+
+    void pushLeftPath(const Node* n)
+    {
+        for(; n != nullptr; n = n->left) {
+            if(count == capacity) {
+                grow();
+            }
+            path[count++] = n;
+        }
+    }
+
+    void grow()
+    {
+        unsigned int newCapacity = capacity == 0 ? 8 : capacity * 2;
+        const Node** larger = new const Node*[newCapacity];
+        std::copy(path, path + count, larger);
+        delete[] path;
+        path = larger;
+        capacity = newCapacity;
+    }
+
+    const Node** path = nullptr;
+    unsigned int count = 0;
+    unsigned int capacity = 0;
+};
+
+
+
 #endif // AVLSET_HPP
 
@@ -0,0 +1,174 @@
+// BlockedBloomFilter.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Implementation of BlockedBloomFilter.
+
+#include "BlockedBloomFilter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "StringHashers.hpp"
+
+
+namespace
+{
+    // The bits for one string are chosen by "double hashing": the i-th bit
+    // is (a + i * b) mod 512, where a and b come from the string's hash.
+    // b is made odd so that the k bits are all different.
+    struct Probe
+    {
+        std::uint32_t block;
+        std::uint32_t a;
+        std::uint32_t b;
+    };
+
+
+    Probe probeFor(std::string_view element, unsigned int blockCount)
+    {
+        std::uint64_t hash = WyStringHash{}(element);
+        std::uint64_t bits = impl_::stringHashMix(hash, 0xe7037ed1a0b428dbull);
+        return Probe{
+            static_cast<std::uint32_t>(((hash >> 32) * blockCount) >> 32),
+            static_cast<std::uint32_t>(bits),
+            static_cast<std::uint32_t>(bits >> 32) | 1u};
+    }
+}
+
+
+
+BlockedBloomFilter::BlockedBloomFilter(unsigned int expectedElements, unsigned int bitsPerElement)
+    : blocks{nullptr}, blockCount{0}, k{0}, sz{0}
+{
+    std::uint64_t bits = std::uint64_t{std::max(expectedElements, 1u)} * std::max(bitsPerElement, 1u);
+    blockCount = static_cast<unsigned int>((bits + BLOCK_BITS - 1) / BLOCK_BITS);
+    k = static_cast<unsigned int>(std::lround(std::max(bitsPerElement, 1u) * 0.6931471805599453));
+    k = std::min(std::max(k, 1u), 16u);
+
+    blocks = new Block[blockCount];
+    for(unsigned int i=0; i < blockCount; i++) {
+        std::fill(std::begin(blocks[i].words), std::end(blocks[i].words), 0);
+    }
+}
+
+
+BlockedBloomFilter::~BlockedBloomFilter() noexcept
+{
+    delete[] blocks;
+}
+
+
+BlockedBloomFilter::BlockedBloomFilter(const BlockedBloomFilter& f)
+    : blocks{new Block[f.blockCount]}, blockCount{f.blockCount}, k{f.k}, sz{f.sz}
+{
+    std::copy(f.blocks, f.blocks + blockCount, blocks);
+}
+
+
+// A moved-from filter has no blocks, and says "maybe" about everything,
+// which is always a safe answer.
+BlockedBloomFilter::BlockedBloomFilter(BlockedBloomFilter&& f) noexcept
+    : blocks{f.blocks}, blockCount{f.blockCount}, k{f.k}, sz{f.sz}
+{
+    f.blocks = nullptr;
+    f.blockCount = 0;
+    f.sz = 0;
+}
+
+
+BlockedBloomFilter& BlockedBloomFilter::operator=(const BlockedBloomFilter& f)
+{
+    if(this != &f) {
+        BlockedBloomFilter copy{f};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+BlockedBloomFilter& BlockedBloomFilter::operator=(BlockedBloomFilter&& f) noexcept
+{
+    if(this != &f) {
+        std::swap(blocks, f.blocks);
+        std::swap(blockCount, f.blockCount);
+        std::swap(k, f.k);
+        std::swap(sz, f.sz);
+    }
+    return *this;
+}
+
+
+void BlockedBloomFilter::add(std::string_view element)
+{
+    if(blockCount == 0) {
+        return;
+    }
+
+    Probe probe = probeFor(element, blockCount);
+    Block& block = blocks[probe.block];
+    for(unsigned int i=0; i < k; i++) {
+        std::uint32_t bit = (probe.a + i * probe.b) % BLOCK_BITS;
+        block.words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    }
+    sz += 1;
+}
+
+
+bool BlockedBloomFilter::mayContain(std::string_view element) const noexcept
+{
+    if(blockCount == 0) {
+        return true;
+    }
+
+    Probe probe = probeFor(element, blockCount);
+    const Block& block = blocks[probe.block];
+    std::uint64_t missing = 0;
+    for(unsigned int i=0; i < k; i++) {
+        std::uint32_t bit = (probe.a + i * probe.b) % BLOCK_BITS;
+        missing |= ~block.words[bit / 64] & (std::uint64_t{1} << (bit % 64));
+    }
+    return missing == 0;
+}
+
+
+unsigned int BlockedBloomFilter::size() const noexcept
+{
+    return sz;
+}
+
+
+unsigned int BlockedBloomFilter::hashCount() const noexcept
+{
+    return k;
+}
+
+
+std::size_t BlockedBloomFilter::memoryBytes() const noexcept
+{
+    return sizeof(Block) * blockCount;
+}
+
+
+// The strings are spread over the blocks unevenly, so the rate is worked
+// out by weighting the false positive rate of a block holding j strings
+// by the (Poisson) probability that a block holds j strings.
+double BlockedBloomFilter::falsePositiveRate() const
+{
+    if(blockCount == 0) {
+        return 1.0;
+    }
+
+    double lambda = 1.0 * sz / blockCount;
+    double bitStaysClear = 1.0 - 1.0 / BLOCK_BITS;
+    unsigned int limit = static_cast<unsigned int>(lambda + 10.0 * std::sqrt(lambda) + 20.0);
+
+    double rate = 0.0;
+    double probability = std::exp(-lambda);
+    for(unsigned int j=0; j <= limit; j++) {
+        double blockRate = std::pow(1.0 - std::pow(bitStaysClear, 1.0 * k * j), k);
+        rate += probability * blockRate;
+        probability *= lambda / (j + 1);
+    }
+    return rate;
+}
@@ -0,0 +1,443 @@
+// CompactAVLSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A CompactAVLSet is an AVL tree, like an AVLSet, whose nodes are all kept
+// in contiguous arrays instead of being allocated separately.  A node is
+// identified by its index in those arrays, so the links between nodes are
+// 32-bit indices rather than 64-bit pointers.
+//
+// Each node's links and height are kept in one array, and its element in
+// another.  Walking down the tree reads one small Link for each node it
+// passes through, plus the element it's comparing against, so a lookup
+// touches far less memory than it would if every node were a separate
+// allocation holding its element inline.  The arrays grow by doubling, as
+// a std::vector would, and elements are moved (not copied) when they do.
+//
+// Since indices are 32 bits, and one of them is set aside to mean "no
+// node," a CompactAVLSet can hold up to 2^32 - 1 elements; adding another
+// throws a std::length_error.
+
+#ifndef COMPACTAVLSET_HPP
+#define COMPACTAVLSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "AVLSet.hpp"
+#include "Set.hpp"
+
+
+
+template <typename ElementType>
+class CompactAVLSet : public Set<ElementType>
+{
+public:
+    // A VisitFunction is a function that takes a reference to a const
+    // ElementType and returns no value.
+    using VisitFunction = std::function<void(const ElementType&)>;
+
+    // The most elements a CompactAVLSet can hold.
+    static constexpr unsigned int MAX_SIZE = 0xFFFFFFFFu;
+
+public:
+    // Initializes a CompactAVLSet to be empty, with or without balancing.
+    explicit CompactAVLSet(bool shouldBalance = true);
+
+    // Cleans up the CompactAVLSet so that it leaks no memory.
+    virtual ~CompactAVLSet() noexcept;
+
+    // Initializes a new CompactAVLSet to be a copy of an existing one.
+    CompactAVLSet(const CompactAVLSet& s);
+
+    // Initializes a new CompactAVLSet whose contents are moved from an
+    // expiring one.
+    CompactAVLSet(CompactAVLSet&& s) noexcept;
+
+    // Assigns an existing CompactAVLSet into another.
+    CompactAVLSet& operator=(const CompactAVLSet& s);
+
+    // Assigns an expiring CompactAVLSet into another.
+    CompactAVLSet& operator=(CompactAVLSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in O(log n)
+    // time when there are n elements in the set (amortized, since the
+    // arrays occasionally have to grow).  It throws a std::length_error if
+    // the set already holds MAX_SIZE elements.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function always runs in O(log n) time.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // containsKey() is contains() for a key that can be of some type other
+    // than ElementType, as in AVLSet.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
+    virtual unsigned int size() const noexcept override;
+
+
+    // height() returns the height of the AVL tree, which is -1 when the
+    // tree is empty.
+    int height() const;
+
+
+    // reserve() makes room for at least the given number of elements, so
+    // that adding that many won't make the arrays grow.
+    void reserve(unsigned int elementCount);
+
+
+    // memoryBytes() returns the size of the arrays holding the nodes.
+    std::size_t memoryBytes() const noexcept;
+
+
+    // inorder() calls the given "visit" function for each of the elements
+    // in the set, in ascending order.
+    void inorder(VisitFunction visit) const;
+
+
+private:
+    // NIL is one past the last index a node can have.
+    static constexpr std::uint32_t NIL = MAX_SIZE;
+    static constexpr unsigned int FIRST_CAPACITY = 16;
+
+    struct Link {
+        std::uint32_t left;
+        std::uint32_t right;
+        int h;
+    };
+
+    ElementType* keys;
+    Link* links;
+    unsigned int capacity;
+    unsigned int sz;
+    std::uint32_t root;
+    bool balancing;
+
+    void grow(unsigned int newCapacity);
+    void destroyAll() noexcept;
+    int heightOf(std::uint32_t n) const noexcept;
+    int difference(std::uint32_t n) const noexcept;
+    void updateHeight(std::uint32_t n) noexcept;
+    std::uint32_t rotateRight(std::uint32_t n) noexcept;
+    std::uint32_t rotateLeft(std::uint32_t n) noexcept;
+};
+
+
+
+template <typename ElementType>
+CompactAVLSet<ElementType>::CompactAVLSet(bool shouldBalance)
+    : keys{nullptr}, links{nullptr}, capacity{0}, sz{0}, root{NIL}, balancing{shouldBalance}
+{
+}
+
+
+template <typename ElementType>
+CompactAVLSet<ElementType>::~CompactAVLSet() noexcept
+{
+    destroyAll();
+}
+
+
+// Since nodes are identified by their indices, a copy can copy the arrays
+// as they are, and every link in it is still right.
+template <typename ElementType>
+CompactAVLSet<ElementType>::CompactAVLSet(const CompactAVLSet& s)
+    : CompactAVLSet{s.balancing}
+{
+    reserve(s.sz);
+    for(unsigned int i = 0; i < s.sz; i++) {
+        new (keys + i) ElementType{s.keys[i]};
+        links[i] = s.links[i];
+        sz = i + 1;
+    }
+    root = s.root;
+}
+
+
+template <typename ElementType>
+CompactAVLSet<ElementType>::CompactAVLSet(CompactAVLSet&& s) noexcept
+    : CompactAVLSet{s.balancing}
+{
+    std::swap(keys, s.keys);
+    std::swap(links, s.links);
+    std::swap(capacity, s.capacity);
+    std::swap(sz, s.sz);
+    std::swap(root, s.root);
+}
+
+
+template <typename ElementType>
+CompactAVLSet<ElementType>& CompactAVLSet<ElementType>::operator=(const CompactAVLSet& s)
+{
+    if(this != &s) {
+        CompactAVLSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+CompactAVLSet<ElementType>& CompactAVLSet<ElementType>::operator=(CompactAVLSet&& s) noexcept
+{
+    if(this != &s) {
+        std::swap(keys, s.keys);
+        std::swap(links, s.links);
+        std::swap(capacity, s.capacity);
+        std::swap(sz, s.sz);
+        std::swap(root, s.root);
+        std::swap(balancing, s.balancing);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+bool CompactAVLSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+// add() works the way AVLSet::add() does, remembering the path it took as
+// the addresses of the links it followed.  The arrays are grown before the
+// walk, if they're full, so that those addresses stay valid.
+template <typename ElementType>
+void CompactAVLSet<ElementType>::add(const ElementType& element)
+{
+    if(sz == capacity) {
+        if(capacity == MAX_SIZE) {
+            if(contains(element)) {
+                return;
+            }
+            throw std::length_error{"CompactAVLSet::add(): the set is full"};
+        }
+        grow(capacity == 0 ? FIRST_CAPACITY : (capacity > MAX_SIZE / 2 ? MAX_SIZE : capacity * 2));
+    }
+
+    impl_::AVLPathStack<std::uint32_t*> path;
+    std::uint32_t* link = &root;
+    while(*link != NIL) {
+        int c = impl_::avlCompare(element, keys[*link]);
+        if(c == 0) {
+            return;
+        }
+        path.push(link);
+        link = c < 0 ? &links[*link].left : &links[*link].right;
+    }
+
+    new (keys + sz) ElementType{element};
+    links[sz] = Link{NIL, NIL, 0};
+    *link = sz;
+    sz += 1;
+
+    while(!path.empty()) {
+        link = path.pop();
+        std::uint32_t n = *link;
+        int oldHeight = links[n].h;
+        updateHeight(n);
+
+        if(balancing) {
+            int b = difference(n);
+            if(b > 1) {
+                if(difference(links[n].left) < 0) {
+                    links[n].left = rotateLeft(links[n].left);
+                }
+                *link = rotateRight(n);
+                return;
+            }
+            if(b < -1) {
+                if(difference(links[n].right) > 0) {
+                    links[n].right = rotateRight(links[n].right);
+                }
+                *link = rotateLeft(n);
+                return;
+            }
+        }
+
+        if(links[n].h == oldHeight) {
+            return;
+        }
+    }
+}
+
+
+template <typename ElementType>
+bool CompactAVLSet<ElementType>::contains(const ElementType& element) const
+{
+    return containsKey(element);
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool CompactAVLSet<ElementType>::containsKey(const Key& key) const
+{
+    std::uint32_t n = root;
+    while(n != NIL) {
+        int c = impl_::avlCompare(key, keys[n]);
+        if(c == 0) {
+            return true;
+        }
+        n = c < 0 ? links[n].left : links[n].right;
+    }
+    return false;
+}
+
+
+template <typename ElementType>
+unsigned int CompactAVLSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+int CompactAVLSet<ElementType>::height() const
+{
+    return heightOf(root);
+}
+
+
+template <typename ElementType>
+void CompactAVLSet<ElementType>::reserve(unsigned int elementCount)
+{
+    if(elementCount > capacity) {
+        grow(elementCount);
+    }
+}
+
+
+template <typename ElementType>
+std::size_t CompactAVLSet<ElementType>::memoryBytes() const noexcept
+{
+    return (sizeof(ElementType) + sizeof(Link)) * std::size_t{capacity};
+}
+
+
+template <typename ElementType>
+void CompactAVLSet<ElementType>::inorder(VisitFunction visit) const
+{
+    impl_::AVLPathStack<std::uint32_t> path;
+    std::uint32_t n = root;
+    while(n != NIL || !path.empty()) {
+        while(n != NIL) {
+            path.push(n);
+            n = links[n].left;
+        }
+        n = path.pop();
+        visit(keys[n]);
+        n = links[n].right;
+    }
+}
+
+
+// The element array is raw memory, with elements constructed in it only
+// as they're added, so that spare capacity doesn't hold default-constructed
+// elements.
+template <typename ElementType>
+void CompactAVLSet<ElementType>::grow(unsigned int newCapacity)
+{
+    ElementType* newKeys = static_cast<ElementType*>(::operator new(sizeof(ElementType) * std::size_t{newCapacity}));
+    Link* newLinks;
+    try {
+        newLinks = new Link[newCapacity];
+    }
+    catch(...) {
+        ::operator delete(newKeys);
+        throw;
+    }
+
+    for(unsigned int i = 0; i < sz; i++) {
+        new (newKeys + i) ElementType{std::move_if_noexcept(keys[i])};
+        keys[i].~ElementType();
+        newLinks[i] = links[i];
+    }
+
+    ::operator delete(keys);
+    delete[] links;
+    keys = newKeys;
+    links = newLinks;
+    capacity = newCapacity;
+}
+
+
+template <typename ElementType>
+void CompactAVLSet<ElementType>::destroyAll() noexcept
+{
+    for(unsigned int i = 0; i < sz; i++) {
+        keys[i].~ElementType();
+    }
+    ::operator delete(keys);
+    delete[] links;
+    keys = nullptr;
+    links = nullptr;
+    capacity = 0;
+    sz = 0;
+    root = NIL;
+}
+
+
+template <typename ElementType>
+int CompactAVLSet<ElementType>::heightOf(std::uint32_t n) const noexcept
+{
+    return n == NIL ? -1 : links[n].h;
+}
+
+
+template <typename ElementType>
+int CompactAVLSet<ElementType>::difference(std::uint32_t n) const noexcept
+{
+    return n == NIL ? 0 : heightOf(links[n].left) - heightOf(links[n].right);
+}
+
+
+template <typename ElementType>
+void CompactAVLSet<ElementType>::updateHeight(std::uint32_t n) noexcept
+{
+    int l = heightOf(links[n].left);
+    int r = heightOf(links[n].right);
+    links[n].h = (l > r ? l : r) + 1;
+}
+
+
+template <typename ElementType>
+std::uint32_t CompactAVLSet<ElementType>::rotateRight(std::uint32_t n) noexcept
+{
+    std::uint32_t x = links[n].left;
+    links[n].left = links[x].right;
+    links[x].right = n;
+    updateHeight(n);
+    updateHeight(x);
+    return x;
+}
+
+
+template <typename ElementType>
+std::uint32_t CompactAVLSet<ElementType>::rotateLeft(std::uint32_t n) noexcept
+{
+    std::uint32_t y = links[n].right;
+    links[n].right = links[y].left;
+    links[y].left = n;
+    updateHeight(n);
+    updateHeight(y);
+    return y;
+}
+
+
+
+#endif // COMPACTAVLSET_HPP
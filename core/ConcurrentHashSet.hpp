@@ -0,0 +1,515 @@
+// ConcurrentHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A ConcurrentHashSet is an implementation of a Set that is a separately-
+// chained hash table, like HashSet, except that any number of threads can
+// use it at the same time.
+//
+// Lookups never block: contains() reads the current array and walks one
+// chain without taking any locks.  This is safe because a node is never
+// changed once it has been published at the head of its chain, and because
+// the nodes and arrays replaced by a resize are "retired" rather than
+// deleted, so a reader that is still looking at an old array sees a
+// complete and unchanging picture of the set as it was.
+//
+// Retired arrays are deleted once no reader can still be looking at them,
+// which is decided with epochs.  Every lookup announces itself by counting
+// itself in one of two counters, chosen by whether the current epoch is
+// even or odd, and uncounts itself when it's done.  An array retired during
+// epoch E can only be seen by lookups that began during epoch E or before.
+// The epoch only advances from E to E + 1 once no lookup that began during
+// E - 1 is still running, so by the time it reaches E + 2, every lookup
+// that began during E has finished, and the array can be deleted.  The
+// counters are spread across READER_SLOTS cache lines, chosen by thread,
+// so that lookups in different threads don't fight over one cache line.
+// Only adds try to advance the epoch and delete retired arrays, whenever
+// there are some, so that a lookup never takes on the work of deleting a
+// whole array; they're deleted by the first add after the lookups that
+// might see them have finished, or when the set is destroyed.
+//
+// Calls to add() take one of LOCK_STRIPES locks, chosen from the element's
+// hash, so that adds into different parts of the table proceed in parallel.
+// The number of cells in the array is always a multiple of LOCK_STRIPES,
+// which guarantees that any two elements that can land in the same cell are
+// guarded by the same lock.  Resizing takes every lock, builds a new array
+// out of copies of the nodes, and then publishes it with a single atomic
+// store.  Copies of the nodes are needed because readers may be walking the
+// old chains at the same moment.
+//
+// Copying, moving, and assigning a ConcurrentHashSet are not themselves
+// safe to do while other threads are using the one being written to.
+
+#ifndef CONCURRENTHASHSET_HPP
+#define CONCURRENTHASHSET_HPP
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "Set.hpp"
+
+
+
+template <typename ElementType>
+class ConcurrentHashSet : public Set<ElementType>
+{
+public:
+    // The number of locks guarding the array.  Each lock guards every cell
+    // whose index is equal to it modulo LOCK_STRIPES.
+    static constexpr unsigned int LOCK_STRIPES = 64;
+
+    // The default capacity of the ConcurrentHashSet before anything has
+    // been added to it.  It must be a multiple of LOCK_STRIPES.
+    static constexpr unsigned int DEFAULT_CAPACITY = LOCK_STRIPES;
+
+    // The number of cache lines over which lookups count themselves.
+    static constexpr unsigned int READER_SLOTS = 16;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.  It will be called from
+    // many threads at once.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a ConcurrentHashSet to be empty, so that it will use the
+    // given hash function whenever it needs to hash an element.
+    explicit ConcurrentHashSet(HashFunction hashFunction);
+
+    // Cleans up the ConcurrentHashSet so that it leaks no memory.
+    virtual ~ConcurrentHashSet() noexcept;
+
+    // Initializes a new ConcurrentHashSet to be a copy of an existing one.
+    // Other threads may keep using the existing one while it's copied.
+    ConcurrentHashSet(const ConcurrentHashSet& s);
+
+    // Initializes a new ConcurrentHashSet whose contents are moved from an
+    // expiring one.
+    ConcurrentHashSet(ConcurrentHashSet&& s) noexcept;
+
+    // Assigns an existing ConcurrentHashSet into another.
+    ConcurrentHashSet& operator=(const ConcurrentHashSet& s);
+
+    // Assigns an expiring ConcurrentHashSet into another.
+    ConcurrentHashSet& operator=(ConcurrentHashSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  It blocks only other calls to
+    // add() that hash to the same lock stripe, or all of them while the
+    // array is being resized.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  It never blocks, and runs in constant time
+    // (assuming a good hash function).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // retiredTables() returns the number of arrays left behind by earlier
+    // resizes that haven't been deleted yet.
+    unsigned int retiredTables() const noexcept;
+
+
+    // reclaim() deletes the nodes and arrays left behind by earlier
+    // resizes right away, without waiting for a later add() to delete
+    // them.  It must only be called when no other thread is
+    // using the set, such as between batches of work.
+    void reclaim() noexcept;
+
+
+private:
+    struct Node {
+        ElementType data;
+        unsigned int hash;
+        Node* next;
+    };
+
+    struct Table {
+        unsigned int amountOfBuckets;
+        std::atomic<Node*>* buckets;
+        Table* retiredNext;
+        unsigned long long retiredEpoch;
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+    };
+
+    // readers[p] is the number of lookups running in this slot's threads
+    // that began during an epoch whose parity is p.
+    struct alignas(64) ReaderSlot {
+        std::atomic<unsigned int> readers[2];
+    };
+
+    HashFunction hashFunction;
+    std::atomic<Table*> table;
+    std::atomic<unsigned int> sz;
+    Stripe stripes[LOCK_STRIPES];
+    mutable ReaderSlot readerSlots[READER_SLOTS];
+    std::atomic<unsigned long long> epoch;
+    std::atomic<unsigned int> retiredCount;
+    std::mutex retiredMutex;
+    Table* retired;
+
+    static Table* makeTable(unsigned int amountOfBuckets);
+    static void deleteTable(Table* t) noexcept;
+    static bool chainContains(Node* node, unsigned int hash, const ElementType& element);
+    static ReaderSlot& slotForThisThread(ReaderSlot* slots) noexcept;
+    void insertCopy(Table* t, const ElementType& element, unsigned int hash);
+    void lockAll() const;
+    void unlockAll() const;
+    void resize(Table* expected);
+    unsigned long long beginLookup(ReaderSlot& slot) const noexcept;
+    void endLookup(ReaderSlot& slot, unsigned long long e) const noexcept;
+    void deleteRetiredBefore(unsigned long long e) noexcept;
+    void collectRetired() noexcept;
+};
+
+
+
+template <typename ElementType>
+typename ConcurrentHashSet<ElementType>::Table* ConcurrentHashSet<ElementType>::makeTable(unsigned int amountOfBuckets)
+{
+    Table* t = new Table{amountOfBuckets, new std::atomic<Node*>[amountOfBuckets], nullptr, 0};
+    for(unsigned int i=0; i < amountOfBuckets; i++) {
+        t->buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return t;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::deleteTable(Table* t) noexcept
+{
+    for(unsigned int i=0; i < t->amountOfBuckets; i++) {
+        Node* n = t->buckets[i].load(std::memory_order_relaxed);
+        while(n != nullptr) {
+            Node* next = n->next;
+            delete n;
+            n = next;
+        }
+    }
+    delete[] t->buckets;
+    delete t;
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::chainContains(Node* node, unsigned int hash, const ElementType& element)
+{
+    while(node != nullptr) {
+        if(node->hash == hash && node->data == element) {
+            return true;
+        }
+        node = node->next;
+    }
+    return false;
+}
+
+
+template <typename ElementType>
+typename ConcurrentHashSet<ElementType>::ReaderSlot& ConcurrentHashSet<ElementType>::slotForThisThread(
+    ReaderSlot* slots) noexcept
+{
+    static thread_local unsigned int index =
+        static_cast<unsigned int>(std::hash<std::thread::id>{}(std::this_thread::get_id()) % READER_SLOTS);
+    return slots[index];
+}
+
+
+// insertCopy() pushes a new node onto the front of its chain in a table
+// that no other thread can be writing into.
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::insertCopy(Table* t, const ElementType& element, unsigned int hash)
+{
+    std::atomic<Node*>& bucket = t->buckets[hash % t->amountOfBuckets];
+    bucket.store(new Node{element, hash, bucket.load(std::memory_order_relaxed)}, std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::lockAll() const
+{
+    for(unsigned int i=0; i < LOCK_STRIPES; i++) {
+        const_cast<Stripe&>(stripes[i]).mutex.lock();
+    }
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::unlockAll() const
+{
+    for(unsigned int i=LOCK_STRIPES; i > 0; i--) {
+        const_cast<Stripe&>(stripes[i - 1]).mutex.unlock();
+    }
+}
+
+
+// resize() doubles the size of the array, unless some other thread has
+// already replaced the one that was found to be too full.
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::resize(Table* expected)
+{
+    lockAll();
+    Table* old = table.load(std::memory_order_relaxed);
+    bool replaced = old == expected;
+    if(replaced) {
+        Table* t = makeTable(old->amountOfBuckets * 2);
+        for(unsigned int i=0; i < old->amountOfBuckets; i++) {
+            for(Node* n = old->buckets[i].load(std::memory_order_relaxed); n != nullptr; n = n->next) {
+                insertCopy(t, n->data, n->hash);
+            }
+        }
+        table.store(t, std::memory_order_seq_cst);
+    }
+    unlockAll();
+
+    // The old array is retired only after it's been replaced, so any
+    // lookup that can still see it began no later than the current epoch.
+    if(replaced) {
+        std::lock_guard<std::mutex> lock{retiredMutex};
+        old->retiredEpoch = epoch.load(std::memory_order_seq_cst);
+        old->retiredNext = retired;
+        retired = old;
+        retiredCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+// beginLookup() counts a lookup as running during the current epoch, and
+// returns that epoch.  If the epoch advances while it's being counted, the
+// count might be in the wrong counter, so it's moved and tried again.
+template <typename ElementType>
+unsigned long long ConcurrentHashSet<ElementType>::beginLookup(ReaderSlot& slot) const noexcept
+{
+    while(true) {
+        unsigned long long e = epoch.load(std::memory_order_seq_cst);
+        slot.readers[e % 2].fetch_add(1, std::memory_order_seq_cst);
+        if(epoch.load(std::memory_order_seq_cst) == e) {
+            return e;
+        }
+        slot.readers[e % 2].fetch_sub(1, std::memory_order_release);
+    }
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::endLookup(ReaderSlot& slot, unsigned long long e) const noexcept
+{
+    slot.readers[e % 2].fetch_sub(1, std::memory_order_release);
+}
+
+
+// deleteRetiredBefore() deletes every retired array that was retired
+// before the given epoch.  The retiredMutex must be held.
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::deleteRetiredBefore(unsigned long long e) noexcept
+{
+    Table** link = &retired;
+    while(*link != nullptr) {
+        Table* t = *link;
+        if(t->retiredEpoch < e) {
+            *link = t->retiredNext;
+            deleteTable(t);
+            retiredCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        else {
+            link = &t->retiredNext;
+        }
+    }
+}
+
+
+// collectRetired() advances the epoch as far as two steps, for as long as
+// no lookup that began during the previous one is still running, and
+// deletes the retired arrays that no lookup can see anymore.  Two steps are
+// enough to delete an array retired during the current epoch, so when no
+// lookups are running, an add() that resizes deletes the old array before
+// it returns.  If another thread is already doing this, it does nothing.
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::collectRetired() noexcept
+{
+    std::unique_lock<std::mutex> lock{retiredMutex, std::try_to_lock};
+    if(!lock.owns_lock()) {
+        return;
+    }
+
+    unsigned long long e = epoch.load(std::memory_order_seq_cst);
+    for(unsigned int step=0; step < 2; step++) {
+        bool previousDone = true;
+        for(unsigned int i=0; i < READER_SLOTS && previousDone; i++) {
+            previousDone = readerSlots[i].readers[(e + 1) % 2].load(std::memory_order_seq_cst) == 0;
+        }
+        if(!previousDone) {
+            break;
+        }
+        e += 1;
+        epoch.store(e, std::memory_order_seq_cst);
+    }
+    if(e >= 2) {
+        deleteRetiredBefore(e - 1);
+    }
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ConcurrentHashSet(HashFunction hashFunction)
+    : hashFunction{hashFunction}, table{makeTable(DEFAULT_CAPACITY)}, sz{0},
+      readerSlots{}, epoch{0}, retiredCount{0}, retired{nullptr}
+{
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::~ConcurrentHashSet() noexcept
+{
+    reclaim();
+    if(table.load() != nullptr) {
+        deleteTable(table.load());
+    }
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ConcurrentHashSet(const ConcurrentHashSet& s)
+    : hashFunction{s.hashFunction}, table{nullptr}, sz{0},
+      readerSlots{}, epoch{0}, retiredCount{0}, retired{nullptr}
+{
+    s.lockAll();
+    Table* source = s.table.load(std::memory_order_relaxed);
+    Table* t = makeTable(source->amountOfBuckets);
+    for(unsigned int i=0; i < source->amountOfBuckets; i++) {
+        for(Node* n = source->buckets[i].load(std::memory_order_relaxed); n != nullptr; n = n->next) {
+            insertCopy(t, n->data, n->hash);
+        }
+    }
+    sz.store(s.sz.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    s.unlockAll();
+    table.store(t, std::memory_order_release);
+}
+
+
+// A moved-from ConcurrentHashSet is left empty, with an array of the
+// default size.  Since no other thread can be using an expiring set, its
+// retired arrays are deleted rather than moved.
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ConcurrentHashSet(ConcurrentHashSet&& s) noexcept
+    : hashFunction{s.hashFunction}, table{s.table.load()}, sz{s.sz.load()},
+      readerSlots{}, epoch{0}, retiredCount{0}, retired{nullptr}
+{
+    s.reclaim();
+    s.table.store(makeTable(DEFAULT_CAPACITY));
+    s.sz.store(0);
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>& ConcurrentHashSet<ElementType>::operator=(const ConcurrentHashSet& s)
+{
+    if(this != &s) {
+        ConcurrentHashSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>& ConcurrentHashSet<ElementType>::operator=(ConcurrentHashSet&& s) noexcept
+{
+    if(this != &s) {
+        reclaim();
+        s.reclaim();
+        std::swap(hashFunction, s.hashFunction);
+        table.store(s.table.exchange(table.load()));
+        sz.store(s.sz.exchange(sz.load()));
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::add(const ElementType& element)
+{
+    unsigned int hash = hashFunction(element);
+    Table* t;
+    bool tooFull;
+    {
+        std::lock_guard<std::mutex> lock{stripes[hash % LOCK_STRIPES].mutex};
+        // Resizing holds every lock, so the array can't change under us now.
+        t = table.load(std::memory_order_relaxed);
+        std::atomic<Node*>& bucket = t->buckets[hash % t->amountOfBuckets];
+        Node* head = bucket.load(std::memory_order_relaxed);
+        if(chainContains(head, hash, element)) {
+            return;
+        }
+        bucket.store(new Node{element, hash, head}, std::memory_order_release);
+        unsigned int newSize = sz.fetch_add(1, std::memory_order_relaxed) + 1;
+        tooFull = 1.0 * newSize / t->amountOfBuckets > 0.8;
+    }
+    if(tooFull) {
+        resize(t);
+    }
+    if(retiredCount.load(std::memory_order_relaxed) != 0) {
+        collectRetired();
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::contains(const ElementType& element) const
+{
+    unsigned int hash = hashFunction(element);
+    ReaderSlot& slot = slotForThisThread(readerSlots);
+    unsigned long long e = beginLookup(slot);
+    Table* t = table.load(std::memory_order_seq_cst);
+    Node* head = t->buckets[hash % t->amountOfBuckets].load(std::memory_order_acquire);
+    bool found = chainContains(head, hash, element);
+    endLookup(slot, e);
+    return found;
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::size() const noexcept
+{
+    return sz.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::retiredTables() const noexcept
+{
+    return retiredCount.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::reclaim() noexcept
+{
+    std::lock_guard<std::mutex> lock{retiredMutex};
+    deleteRetiredBefore(epoch.load(std::memory_order_relaxed) + 1);
+}
+
+
+
+#endif // CONCURRENTHASHSET_HPP
+
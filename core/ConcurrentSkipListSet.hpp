@@ -0,0 +1,426 @@
+// ConcurrentSkipListSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A ConcurrentSkipListSet is an implementation of a Set that is a skip
+// list, like SkipListSet, except that any number of threads can add to it
+// and search it at the same time, without any locks.
+//
+// Each element is stored in a single node, along with a "tower" of next
+// pointers, one for each level the element is on.  (This is what a
+// SkipListSet's column of nodes would look like if it were fused into one,
+// which lets a single compare-and-swap decide where the element belongs.)
+// An element is added by finding its predecessor and successor on every
+// level, pointing its tower at the successors, and then linking it in at
+// level 0 with a compare-and-swap on the predecessor's next pointer; if
+// another thread changed that pointer first, it searches again and retries.
+// The element is in the set from the moment that compare-and-swap
+// succeeds.  It's then linked in on the levels above, one at a time, in the
+// same way; those links only make searches faster, so it doesn't matter
+// that they appear a little later.  This is the lock-free skip list
+// described by Fraser and by Herlihy and Shavit, minus removal.
+//
+// Since nothing is ever removed, a node is never unlinked once it has been
+// published, so there's no memory to reclaim while the set is in use, and
+// no need for the epochs or hazard pointers that a lock-free set with
+// removal would need to know when a node that some thread might still be
+// reading could be freed.  Every node lives until the set is destroyed.
+//
+// Each thread chooses the heights of the towers it builds with its own
+// GeometricSkipListLevelTester, so choosing them needs no synchronization.
+//
+// Copying, moving, and assigning a ConcurrentSkipListSet are not themselves
+// safe to do while other threads are using the one being written to.
+
+#ifndef CONCURRENTSKIPLISTSET_HPP
+#define CONCURRENTSKIPLISTSET_HPP
+
+#include <atomic>
+#include <new>
+#include <utility>
+#include "Set.hpp"
+#include "SkipListSet.hpp"
+
+
+
+template <typename ElementType>
+class ConcurrentSkipListSet : public Set<ElementType>
+{
+public:
+    // The most levels a ConcurrentSkipListSet can have.  Since each level
+    // holds about half as many elements as the one below it, this is
+    // enough for billions of elements.
+    static constexpr unsigned int MAX_LEVELS = 32;
+
+public:
+    // Initializes a ConcurrentSkipListSet to be empty.
+    ConcurrentSkipListSet();
+
+    // Cleans up the ConcurrentSkipListSet so that it leaks no memory.
+    virtual ~ConcurrentSkipListSet() noexcept;
+
+    // Initializes a new ConcurrentSkipListSet to be a copy of an existing
+    // one.  Other threads may keep using the existing one while it's
+    // copied; the copy will contain at least the elements that were in it
+    // before copying began.
+    ConcurrentSkipListSet(const ConcurrentSkipListSet& s);
+
+    // Initializes a new ConcurrentSkipListSet whose contents are moved from
+    // an expiring one.
+    ConcurrentSkipListSet(ConcurrentSkipListSet&& s) noexcept;
+
+    // Assigns an existing ConcurrentSkipListSet into another.
+    ConcurrentSkipListSet& operator=(const ConcurrentSkipListSet& s);
+
+    // Assigns an expiring ConcurrentSkipListSet into another.
+    ConcurrentSkipListSet& operator=(ConcurrentSkipListSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  It never blocks, and runs in an
+    // expected time of O(log n), plus a retry each time another thread
+    // adds an element right next to it at the same moment.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  It never blocks or writes to shared memory, and
+    // runs in an expected time of O(log n).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // containsKey() is contains() for a key that can be of some type other
+    // than ElementType.  Keys and elements must be comparable with < in
+    // both directions.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // levelCount() returns the number of levels that searches currently
+    // start from.
+    unsigned int levelCount() const noexcept;
+
+
+    // rangeVisit() calls the given "visit" function, in ascending order,
+    // for each element that is at least lo and less than hi, as in AVLSet.
+    // It runs in O(log n + k) time when it visits k elements.  Elements
+    // added by other threads while it runs may or may not be visited.
+    template <typename Visitor>
+    void rangeVisit(const ElementType& lo, const ElementType& hi, Visitor visit) const;
+
+
+private:
+    // A Node's tower of next pointers is allocated along with it, just
+    // past its end, so that the whole node is one allocation.
+    struct alignas(std::atomic<void*>) Node {
+        ElementType value;
+        unsigned int height;
+
+        std::atomic<Node*>* links() noexcept
+        {
+            return reinterpret_cast<std::atomic<Node*>*>(this + 1);
+        }
+    };
+
+    Node* head;
+    std::atomic<unsigned int> levels;
+    std::atomic<unsigned int> sz;
+
+    static Node* makeNode(const ElementType& value, unsigned int height);
+    static void destroyNode(Node* node) noexcept;
+    static unsigned int randomHeight(const ElementType& element);
+    void destroyAll() noexcept;
+    template <typename Key>
+    bool find(const Key& key, Node** preds, Node** succs) const;
+    void raiseLevels(unsigned int height) noexcept;
+};
+
+
+
+template <typename ElementType>
+typename ConcurrentSkipListSet<ElementType>::Node* ConcurrentSkipListSet<ElementType>::makeNode(
+    const ElementType& value, unsigned int height)
+{
+    void* memory = ::operator new(sizeof(Node) + sizeof(std::atomic<Node*>) * height);
+    Node* node;
+    try {
+        node = new (memory) Node{value, height};
+    }
+    catch(...) {
+        ::operator delete(memory);
+        throw;
+    }
+
+    std::atomic<Node*>* links = node->links();
+    for(unsigned int level = 0; level < height; level++) {
+        new (links + level) std::atomic<Node*>{nullptr};
+    }
+    return node;
+}
+
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::destroyNode(Node* node) noexcept
+{
+    node->~Node();
+    ::operator delete(node);
+}
+
+
+// Each thread's level tester is built the first time that thread adds an
+// element to any ConcurrentSkipListSet of this type.
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::randomHeight(const ElementType& element)
+{
+    static thread_local GeometricSkipListLevelTester<ElementType> levelTester;
+    return levelTester.levelsToOccupy(element, MAX_LEVELS);
+}
+
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::destroyAll() noexcept
+{
+    Node* n = head;
+    while(n != nullptr) {
+        Node* next = n->links()[0].load(std::memory_order_relaxed);
+        destroyNode(n);
+        n = next;
+    }
+    head = nullptr;
+}
+
+
+// find() fills in, for every level, the last node whose element is less
+// than the key (preds) and the node after it (succs), and returns true if
+// the node after it on level 0 is equivalent to the key.  Unlike
+// containsKey(), it searches all MAX_LEVELS levels, not just the ones that
+// searches currently start from, since another thread may have linked a
+// tall tower into the levels above those without having raised the count
+// of levels yet.
+template <typename ElementType>
+template <typename Key>
+bool ConcurrentSkipListSet<ElementType>::find(const Key& key, Node** preds, Node** succs) const
+{
+    Node* pred = head;
+    for(unsigned int level = MAX_LEVELS; level > 0; level--) {
+        Node* curr = pred->links()[level - 1].load(std::memory_order_acquire);
+        while(curr != nullptr && curr->value < key) {
+            pred = curr;
+            curr = pred->links()[level - 1].load(std::memory_order_acquire);
+        }
+        preds[level - 1] = pred;
+        succs[level - 1] = curr;
+    }
+
+    return succs[0] != nullptr && !(key < succs[0]->value);
+}
+
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::raiseLevels(unsigned int height) noexcept
+{
+    unsigned int top = levels.load(std::memory_order_relaxed);
+    while(top < height && !levels.compare_exchange_weak(top, height, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::ConcurrentSkipListSet()
+    : head{makeNode(ElementType{}, MAX_LEVELS)}, levels{1}, sz{0}
+{
+}
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::~ConcurrentSkipListSet() noexcept
+{
+    destroyAll();
+}
+
+
+// The copy is built by walking level 0 of the existing set and appending
+// each element, with a tower of the same height, after the last tower
+// built so far on each of its levels, which takes O(n) time and no
+// comparisons.  (If building a node throws, the nodes built so far are
+// already linked in, and the destructor cleans them up.)
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::ConcurrentSkipListSet(const ConcurrentSkipListSet& s)
+    : ConcurrentSkipListSet{}
+{
+    Node* tails[MAX_LEVELS];
+    for(unsigned int level = 0; level < MAX_LEVELS; level++) {
+        tails[level] = head;
+    }
+
+    unsigned int count = 0;
+    unsigned int top = 1;
+    Node* n = s.head->links()[0].load(std::memory_order_acquire);
+    for(; n != nullptr; n = n->links()[0].load(std::memory_order_acquire)) {
+        Node* node = makeNode(n->value, n->height);
+        for(unsigned int level = 0; level < n->height; level++) {
+            tails[level]->links()[level].store(node, std::memory_order_relaxed);
+            tails[level] = node;
+        }
+        top = n->height > top ? n->height : top;
+        count++;
+    }
+
+    levels.store(top, std::memory_order_relaxed);
+    sz.store(count, std::memory_order_relaxed);
+}
+
+
+// A moved-from ConcurrentSkipListSet is left empty.
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::ConcurrentSkipListSet(ConcurrentSkipListSet&& s) noexcept
+    : head{s.head}, levels{s.levels.load()}, sz{s.sz.load()}
+{
+    s.head = makeNode(ElementType{}, MAX_LEVELS);
+    s.levels.store(1);
+    s.sz.store(0);
+}
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>& ConcurrentSkipListSet<ElementType>::operator=(const ConcurrentSkipListSet& s)
+{
+    if(this != &s) {
+        ConcurrentSkipListSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>& ConcurrentSkipListSet<ElementType>::operator=(ConcurrentSkipListSet&& s) noexcept
+{
+    if(this != &s) {
+        std::swap(head, s.head);
+        levels.store(s.levels.exchange(levels.load()));
+        sz.store(s.sz.exchange(sz.load()));
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+// Before a tower is linked in on a level, its next pointer there is set to
+// the successor that the compare-and-swap expects to replace, so that the
+// tower is already pointing at the right place the moment it appears.  If
+// the compare-and-swap fails, searching again finds the new predecessor
+// and successor; the tower itself is found as the successor on the levels
+// it's already linked into, and can't be on the others yet.
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::add(const ElementType& element)
+{
+    Node* preds[MAX_LEVELS];
+    Node* succs[MAX_LEVELS];
+    unsigned int height = randomHeight(element);
+    Node* node = nullptr;
+
+    while(true) {
+        if(find(element, preds, succs)) {
+            if(node != nullptr) {
+                destroyNode(node);
+            }
+            return;
+        }
+
+        if(node == nullptr) {
+            node = makeNode(element, height);
+        }
+        node->links()[0].store(succs[0], std::memory_order_relaxed);
+        if(preds[0]->links()[0].compare_exchange_strong(
+            succs[0], node, std::memory_order_release, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    sz.fetch_add(1, std::memory_order_relaxed);
+
+    for(unsigned int level = 1; level < height; level++) {
+        while(true) {
+            node->links()[level].store(succs[level], std::memory_order_relaxed);
+            if(preds[level]->links()[level].compare_exchange_strong(
+                succs[level], node, std::memory_order_release, std::memory_order_relaxed)) {
+                break;
+            }
+            find(element, preds, succs);
+        }
+    }
+
+    raiseLevels(height);
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::contains(const ElementType& element) const
+{
+    return containsKey(element);
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool ConcurrentSkipListSet<ElementType>::containsKey(const Key& key) const
+{
+    Node* pred = head;
+    Node* curr = nullptr;
+    for(unsigned int level = levels.load(std::memory_order_acquire); level > 0; level--) {
+        curr = pred->links()[level - 1].load(std::memory_order_acquire);
+        while(curr != nullptr && curr->value < key) {
+            pred = curr;
+            curr = pred->links()[level - 1].load(std::memory_order_acquire);
+        }
+    }
+    return curr != nullptr && !(key < curr->value);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::size() const noexcept
+{
+    return sz.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::levelCount() const noexcept
+{
+    return levels.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+template <typename Visitor>
+void ConcurrentSkipListSet<ElementType>::rangeVisit(const ElementType& lo, const ElementType& hi, Visitor visit) const
+{
+    Node* preds[MAX_LEVELS];
+    Node* succs[MAX_LEVELS];
+    find(lo, preds, succs);
+
+    for(Node* n = succs[0]; n != nullptr && n->value < hi; n = n->links()[0].load(std::memory_order_acquire)) {
+        visit(n->value);
+    }
+}
+
+
+
+#endif // CONCURRENTSKIPLISTSET_HPP
@@ -0,0 +1,474 @@
+// FlatHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A FlatHashSet is an implementation of a Set that is an open-addressed
+// hash table.  Rather than hanging a linked list off of each cell of the
+// array, the elements are stored directly in one flat array of slots, so
+// that a lookup touches a small, contiguous region of memory instead of
+// chasing pointers from node to node.
+//
+// Alongside the slots is a separate array of "control bytes," one per slot.
+// A control byte is either EMPTY (its high bit set) or holds the low seven
+// bits of the hash of the element in its slot.  Hashes are run through a
+// multiply-xorshift finalizer first, so that every bit of them depends on
+// every bit of what the hash function returned; otherwise, hash functions
+// that return the element itself, or anything else whose low bits rarely
+// differ, would give many elements the same seven bits and crowd them into
+// neighboring groups.  The slots are organized into
+// groups of sixteen, and a lookup compares all sixteen control bytes of a
+// group against the element's seven-bit fragment at once (using SSE2, when
+// it's available), only comparing actual elements whose fragment matched.
+// Groups are probed quadratically until one containing an EMPTY control
+// byte is found.
+//
+// Since elements are never removed from a Set, no "tombstones" are needed.
+// The number of slots is always a power of two, and the table doubles in
+// size whenever adding an element would make it more than 7/8 full.  The
+// full (mixed) hash of each element is kept in a third array, so that
+// doubling the table can move every element into its new slot without
+// hashing it again.
+
+#ifndef FLATHASHSET_HPP
+#define FLATHASHSET_HPP
+
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <utility>
+#include "Set.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+
+template <typename ElementType>
+class FlatHashSet : public Set<ElementType>
+{
+public:
+    // The number of slots in a FlatHashSet before anything has been added
+    // to it.  It is always a multiple of GROUP_WIDTH.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+    // The number of control bytes that are compared with one another at a
+    // time during a lookup.
+    static constexpr unsigned int GROUP_WIDTH = 16;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a FlatHashSet to be empty, so that it will use the given
+    // hash function whenever it needs to hash an element.
+    explicit FlatHashSet(HashFunction hashFunction);
+
+    // Cleans up the FlatHashSet so that it leaks no memory.
+    virtual ~FlatHashSet() noexcept;
+
+    // Initializes a new FlatHashSet to be a copy of an existing one.
+    FlatHashSet(const FlatHashSet& s);
+
+    // Initializes a new FlatHashSet whose contents are moved from an
+    // expiring one.
+    FlatHashSet(FlatHashSet&& s) noexcept;
+
+    // Assigns an existing FlatHashSet into another.
+    FlatHashSet& operator=(const FlatHashSet& s);
+
+    // Assigns an expiring FlatHashSet into another.
+    FlatHashSet& operator=(FlatHashSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function triggers a resizing
+    // of the table when more than 7/8 of its slots would be occupied, in
+    // which case it runs in linear time; otherwise, it runs in constant
+    // time (assuming a good hash function).
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in constant time (assuming a
+    // good hash function), usually examining a single group of control
+    // bytes and a single slot.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // containsKey() returns true if the set contains an element equal to
+    // the given key, which can be of some type other than ElementType (such
+    // as a std::string_view, when the elements are std::strings).  The given
+    // keyHash function must hash each key to the same value that the set's
+    // hash function gives to an element equal to it.
+    template <typename Key, typename KeyHashFunction>
+    bool containsKey(const Key& key, KeyHashFunction keyHash) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // capacity() returns the number of slots in the table.
+    unsigned int capacity() const noexcept;
+
+
+private:
+    static constexpr unsigned char EMPTY = 0x80;
+
+    struct alignas(16) Group {
+        unsigned char control[GROUP_WIDTH];
+    };
+
+    HashFunction hashFunction;
+    unsigned int amountOfGroups;
+    unsigned int sz;
+    Group* groups;
+    ElementType* slots;
+    unsigned int* hashes;
+
+    static std::uint32_t matchByte(const Group& group, unsigned char b);
+    static std::uint32_t matchEmpty(const Group& group);
+    static unsigned int lowestBit(std::uint32_t mask);
+    static unsigned int mix(unsigned int hash) noexcept;
+    template <typename Key>
+    static int findSlot(const Group* groups, const ElementType* slots, unsigned int amountOfGroups,
+        unsigned int hash, const Key& element);
+    void allocate(unsigned int amountOfGroups);
+    void destroy() noexcept;
+    unsigned int emptySlotFor(unsigned int hash) const;
+    void occupy(unsigned int slot, unsigned int hash) noexcept;
+    void grow();
+};
+
+
+
+template <typename ElementType>
+std::uint32_t FlatHashSet<ElementType>::matchByte(const Group& group, unsigned char b)
+{
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group.control));
+    __m128i match = _mm_set1_epi8(static_cast<char>(b));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, match)));
+#else
+    std::uint32_t mask = 0;
+    for(unsigned int i=0; i < GROUP_WIDTH; i++) {
+        if(group.control[i] == b) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+
+template <typename ElementType>
+std::uint32_t FlatHashSet<ElementType>::matchEmpty(const Group& group)
+{
+#if defined(__SSE2__)
+    // EMPTY is the only control byte with its high bit set, so the sign
+    // bits of the sixteen bytes are exactly the mask of empty slots.
+    __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group.control));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+    return matchByte(group, EMPTY);
+#endif
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::lowestBit(std::uint32_t mask)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+    unsigned int i = 0;
+    while((mask & 1u) == 0) {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+
+// mix() is the finalizer from MurmurHash3, which makes each bit of its
+// result depend on every bit of the given hash.
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::mix(unsigned int hash) noexcept
+{
+    std::uint32_t h = hash;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+
+// findSlot() returns the index of the slot holding the given element, or
+// -1 if it isn't in the table.  The hash must already be mixed.  Its upper
+// bits choose the first group to look in; the low seven bits are compared
+// against the control bytes.
+template <typename ElementType>
+template <typename Key>
+int FlatHashSet<ElementType>::findSlot(const Group* groups, const ElementType* slots,
+    unsigned int amountOfGroups, unsigned int hash, const Key& element)
+{
+    unsigned char fragment = hash & 0x7F;
+    unsigned int mask = amountOfGroups - 1;
+    unsigned int g = (hash >> 7) & mask;
+    for(unsigned int step=1; step <= amountOfGroups; step++) {
+        std::uint32_t candidates = matchByte(groups[g], fragment);
+        while(candidates != 0) {
+            unsigned int i = g * GROUP_WIDTH + lowestBit(candidates);
+            if(slots[i] == element) {
+                return static_cast<int>(i);
+            }
+            candidates &= candidates - 1;
+        }
+        if(matchEmpty(groups[g]) != 0) {
+            return -1;
+        }
+        g = (g + step) & mask;
+    }
+    return -1;
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::allocate(unsigned int amount)
+{
+    amountOfGroups = amount;
+    groups = new Group[amountOfGroups];
+    for(unsigned int g=0; g < amountOfGroups; g++) {
+        for(unsigned int i=0; i < GROUP_WIDTH; i++) {
+            groups[g].control[i] = EMPTY;
+        }
+    }
+    slots = static_cast<ElementType*>(
+        ::operator new(sizeof(ElementType) * amountOfGroups * GROUP_WIDTH));
+    hashes = new unsigned int[amountOfGroups * GROUP_WIDTH];
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::destroy() noexcept
+{
+    if(groups != nullptr) {
+        for(unsigned int g=0; g < amountOfGroups; g++) {
+            for(unsigned int i=0; i < GROUP_WIDTH; i++) {
+                if(groups[g].control[i] != EMPTY) {
+                    slots[g * GROUP_WIDTH + i].~ElementType();
+                }
+            }
+        }
+    }
+    delete[] groups;
+    ::operator delete(slots);
+    delete[] hashes;
+    groups = nullptr;
+    slots = nullptr;
+    hashes = nullptr;
+    amountOfGroups = 0;
+    sz = 0;
+}
+
+
+// emptySlotFor() returns the index of the first empty slot along the probe
+// sequence of the given hash.  There must be at least one empty slot in
+// the table.
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::emptySlotFor(unsigned int hash) const
+{
+    unsigned int mask = amountOfGroups - 1;
+    unsigned int g = (hash >> 7) & mask;
+    std::uint32_t empties = matchEmpty(groups[g]);
+    for(unsigned int step=1; empties == 0; step++) {
+        g = (g + step) & mask;
+        empties = matchEmpty(groups[g]);
+    }
+    return g * GROUP_WIDTH + lowestBit(empties);
+}
+
+
+// occupy() marks a slot, into which an element has just been constructed,
+// as holding an element with the given hash.
+template <typename ElementType>
+void FlatHashSet<ElementType>::occupy(unsigned int slot, unsigned int hash) noexcept
+{
+    groups[slot / GROUP_WIDTH].control[slot % GROUP_WIDTH] = hash & 0x7F;
+    hashes[slot] = hash;
+    sz += 1;
+}
+
+
+// grow() doubles the table, moving each element into its new slot using
+// the hash it was stored with.
+template <typename ElementType>
+void FlatHashSet<ElementType>::grow()
+{
+    Group* oldGroups = groups;
+    ElementType* oldSlots = slots;
+    unsigned int* oldHashes = hashes;
+    unsigned int oldAmountOfGroups = amountOfGroups;
+    unsigned int oldSz = sz;
+
+    allocate(oldAmountOfGroups == 0 ? DEFAULT_CAPACITY / GROUP_WIDTH : oldAmountOfGroups * 2);
+    sz = 0;
+    for(unsigned int g=0; g < oldAmountOfGroups; g++) {
+        for(unsigned int i=0; i < GROUP_WIDTH; i++) {
+            if(oldGroups[g].control[i] != EMPTY) {
+                unsigned int old = g * GROUP_WIDTH + i;
+                unsigned int slot = emptySlotFor(oldHashes[old]);
+                new (&slots[slot]) ElementType(std::move_if_noexcept(oldSlots[old]));
+                occupy(slot, oldHashes[old]);
+                oldSlots[old].~ElementType();
+            }
+        }
+    }
+    sz = oldSz;
+    delete[] oldGroups;
+    ::operator delete(oldSlots);
+    delete[] oldHashes;
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(HashFunction hashFunction)
+    : hashFunction{hashFunction}, amountOfGroups{0}, sz{0}, groups{nullptr}, slots{nullptr}, hashes{nullptr}
+{
+    allocate(DEFAULT_CAPACITY / GROUP_WIDTH);
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::~FlatHashSet() noexcept
+{
+    destroy();
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(const FlatHashSet& s)
+    : hashFunction{s.hashFunction}, amountOfGroups{0}, sz{0}, groups{nullptr}, slots{nullptr}, hashes{nullptr}
+{
+    allocate(s.amountOfGroups);
+    for(unsigned int g=0; g < amountOfGroups; g++) {
+        for(unsigned int i=0; i < GROUP_WIDTH; i++) {
+            if(s.groups[g].control[i] != EMPTY) {
+                new (&slots[g * GROUP_WIDTH + i]) ElementType(s.slots[g * GROUP_WIDTH + i]);
+                occupy(g * GROUP_WIDTH + i, s.hashes[g * GROUP_WIDTH + i]);
+            }
+        }
+    }
+}
+
+
+// A moved-from FlatHashSet is left with no table at all; the first add()
+// into it allocates one.
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(FlatHashSet&& s) noexcept
+    : hashFunction{s.hashFunction}, amountOfGroups{0}, sz{0}, groups{nullptr}, slots{nullptr}, hashes{nullptr}
+{
+    std::swap(amountOfGroups, s.amountOfGroups);
+    std::swap(sz, s.sz);
+    std::swap(groups, s.groups);
+    std::swap(slots, s.slots);
+    std::swap(hashes, s.hashes);
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>& FlatHashSet<ElementType>::operator=(const FlatHashSet& s)
+{
+    if(this != &s) {
+        FlatHashSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>& FlatHashSet<ElementType>::operator=(FlatHashSet&& s) noexcept
+{
+    if(this != &s) {
+        std::swap(hashFunction, s.hashFunction);
+        std::swap(amountOfGroups, s.amountOfGroups);
+        std::swap(sz, s.sz);
+        std::swap(groups, s.groups);
+        std::swap(slots, s.slots);
+        std::swap(hashes, s.hashes);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::add(const ElementType& element)
+{
+    unsigned int hash = mix(hashFunction(element));
+    if(amountOfGroups != 0 && findSlot(groups, slots, amountOfGroups, hash, element) >= 0) {
+        return;
+    }
+    if(8ull * (sz + 1) > 7ull * amountOfGroups * GROUP_WIDTH) {
+        grow();
+    }
+    unsigned int slot = emptySlotFor(hash);
+    new (&slots[slot]) ElementType(element);
+    occupy(slot, hash);
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::contains(const ElementType& element) const
+{
+    if(amountOfGroups == 0) {
+        return false;
+    }
+    return findSlot(groups, slots, amountOfGroups, mix(hashFunction(element)), element) >= 0;
+}
+
+
+template <typename ElementType>
+template <typename Key, typename KeyHashFunction>
+bool FlatHashSet<ElementType>::containsKey(const Key& key, KeyHashFunction keyHash) const
+{
+    if(amountOfGroups == 0) {
+        return false;
+    }
+    return findSlot(groups, slots, amountOfGroups, mix(static_cast<unsigned int>(keyHash(key))), key) >= 0;
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::capacity() const noexcept
+{
+    return amountOfGroups * GROUP_WIDTH;
+}
+
+
+
+#endif // FLATHASHSET_HPP
+
@@ -0,0 +1,271 @@
+// FrozenOrderedSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A FrozenOrderedSet is a read-only Set built once from elements in
+// ascending order (for example, by AVLSet::freeze()), and laid out so that
+// looking elements up in it is as fast as possible.
+//
+// The elements are kept in one array in "Eytzinger order": the order in
+// which a breadth-first traversal would visit them if they were arranged in
+// a perfectly balanced binary search tree.  The root is at index 1, and the
+// children of the element at index k are at indices 2k and 2k + 1, so a
+// search moves down the tree by arithmetic instead of by following
+// pointers.  Each step of a search is
+//
+//     k = 2 * k + (elements[k] < key);
+//
+// which compiles to no branches at all, so there's no branch for the
+// processor to mispredict.  The first few levels of the tree share a few
+// cache lines that stay hot, and, since the 16 descendants of element k
+// four levels down are contiguous (at 16k up to 16k + 15), each step
+// prefetches them, so that the memory they'll need is usually already on
+// its way by the time a search gets there.
+//
+// When the search falls off the bottom of the tree, the path it took
+// encodes where it last went left, which is the smallest element not less
+// than the key; the key is in the set only if that element is equal to it.
+
+#ifndef FROZENORDEREDSET_HPP
+#define FROZENORDEREDSET_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <utility>
+#include "Set.hpp"
+
+
+
+// A FrozenOrderedSetException is thrown when something tries to add an
+// element to a FrozenOrderedSet.
+
+class FrozenOrderedSetException
+{
+public:
+    explicit FrozenOrderedSetException(const std::string& reason)
+        : reason_{reason}
+    {
+    }
+
+    const std::string& reason() const
+    {
+        return reason_;
+    }
+
+private:
+    std::string reason_;
+};
+
+
+
+template <typename ElementType>
+class FrozenOrderedSet : public Set<ElementType>
+{
+public:
+    // Initializes a FrozenOrderedSet to be empty.
+    FrozenOrderedSet() noexcept;
+
+    // Initializes a FrozenOrderedSet containing the elements in the range
+    // [first, last), which must be in ascending order with no duplicates.
+    template <typename ForwardIterator>
+    FrozenOrderedSet(ForwardIterator first, ForwardIterator last);
+
+    virtual ~FrozenOrderedSet() noexcept;
+
+    FrozenOrderedSet(const FrozenOrderedSet& s);
+    FrozenOrderedSet(FrozenOrderedSet&& s) noexcept;
+    FrozenOrderedSet& operator=(const FrozenOrderedSet& s);
+    FrozenOrderedSet& operator=(FrozenOrderedSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() always throws a FrozenOrderedSetException, since the set is
+    // read-only.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It runs in O(log n) time, without branching on the
+    // result of any comparison until the very end.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // containsKey() is contains() for a key that can be of some type other
+    // than ElementType.  Keys and elements must be comparable with < in
+    // both directions.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
+    virtual unsigned int size() const noexcept override;
+
+
+private:
+    ElementType* elements;
+    std::size_t sz;
+
+    template <typename ForwardIterator>
+    void fill(std::size_t k, ForwardIterator& next);
+};
+
+
+
+template <typename ElementType>
+FrozenOrderedSet<ElementType>::FrozenOrderedSet() noexcept
+    : elements{nullptr}, sz{0}
+{
+}
+
+
+template <typename ElementType>
+template <typename ForwardIterator>
+FrozenOrderedSet<ElementType>::FrozenOrderedSet(ForwardIterator first, ForwardIterator last)
+    : elements{nullptr}, sz{static_cast<std::size_t>(std::distance(first, last))}
+{
+    elements = new ElementType[sz + 1];
+    try {
+        fill(1, first);
+    }
+    catch(...) {
+        delete[] elements;
+        throw;
+    }
+}
+
+
+template <typename ElementType>
+FrozenOrderedSet<ElementType>::~FrozenOrderedSet() noexcept
+{
+    delete[] elements;
+}
+
+
+template <typename ElementType>
+FrozenOrderedSet<ElementType>::FrozenOrderedSet(const FrozenOrderedSet& s)
+    : elements{nullptr}, sz{s.sz}
+{
+    if(s.elements != nullptr) {
+        elements = new ElementType[sz + 1];
+        try {
+            for(std::size_t k = 1; k <= sz; k++) {
+                elements[k] = s.elements[k];
+            }
+        }
+        catch(...) {
+            delete[] elements;
+            throw;
+        }
+    }
+}
+
+
+template <typename ElementType>
+FrozenOrderedSet<ElementType>::FrozenOrderedSet(FrozenOrderedSet&& s) noexcept
+    : elements{s.elements}, sz{s.sz}
+{
+    s.elements = nullptr;
+    s.sz = 0;
+}
+
+
+template <typename ElementType>
+FrozenOrderedSet<ElementType>& FrozenOrderedSet<ElementType>::operator=(const FrozenOrderedSet& s)
+{
+    if(this != &s) {
+        FrozenOrderedSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+FrozenOrderedSet<ElementType>& FrozenOrderedSet<ElementType>::operator=(FrozenOrderedSet&& s) noexcept
+{
+    if(this != &s) {
+        std::swap(elements, s.elements);
+        std::swap(sz, s.sz);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+bool FrozenOrderedSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void FrozenOrderedSet<ElementType>::add(const ElementType&)
+{
+    throw FrozenOrderedSetException{"a frozen ordered set is read-only"};
+}
+
+
+template <typename ElementType>
+bool FrozenOrderedSet<ElementType>::contains(const ElementType& element) const
+{
+    return containsKey(element);
+}
+
+
+// The search ends with k's binary digits being the path it took (1 for
+// right, 0 for left) below a leading 1.  Shifting off the trailing 1s and
+// the 0 before them backs up to the last place the search went left, which
+// is the smallest element not less than the key, or to 0 if it never went
+// left (so every element is less than the key).
+template <typename ElementType>
+template <typename Key>
+bool FrozenOrderedSet<ElementType>::containsKey(const Key& key) const
+{
+    std::size_t k = 1;
+    while(k <= sz) {
+#if defined(__GNUC__)
+        __builtin_prefetch(elements + 16 * k);
+#endif
+        k = 2 * k + static_cast<std::size_t>(elements[k] < key);
+    }
+
+#if defined(__GNUC__)
+    k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+#else
+    while(k & 1) {
+        k >>= 1;
+    }
+    k >>= 1;
+#endif
+
+    return k != 0 && !(key < elements[k]);
+}
+
+
+template <typename ElementType>
+unsigned int FrozenOrderedSet<ElementType>::size() const noexcept
+{
+    return static_cast<unsigned int>(sz);
+}
+
+
+// fill() places the elements by an inorder traversal of the implicit tree,
+// which visits its positions in ascending order.
+template <typename ElementType>
+template <typename ForwardIterator>
+void FrozenOrderedSet<ElementType>::fill(std::size_t k, ForwardIterator& next)
+{
+    if(k <= sz) {
+        fill(2 * k, next);
+        elements[k] = *next;
+        ++next;
+        fill(2 * k + 1, next);
+    }
+}
+
+
+
+#endif // FROZENORDEREDSET_HPP
@@ -14,25 +14,70 @@
 // elements as there are array cells), the HashSet should be resized so
 // that it is twice as large as it was before.
 //
+// Normally, that resizing happens all at once, within the call to add()
+// that pushed the HashSet over the limit.  A HashSet can instead be asked
+// to resize incrementally, in which case the old array is kept alive next
+// to the new one and a few of its cells are moved over during each later
+// call to add(), so that no single call has to rehash every element.
+//
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the information
 // in your data structure.  Instead, you'll need to use a dynamically-
 // allocated array and your own linked list implemenation; the linked list
 // doesn't have to be its own class, though you can do that, if you'd like.
+//
+// The nodes of the linked lists are allocated from a NodePool owned by the
+// HashSet, so that building a large HashSet doesn't make one allocation per
+// element and destroying one of trivially destructible elements doesn't make
+// one deallocation per element.
 
 #ifndef HASHSET_HPP
 #define HASHSET_HPP
 
+#include <chrono>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "NodePool.hpp"
 #include "Set.hpp"
 
 
 
+// A HashSetStats is a summary of the health of a HashSet, as returned by
+// HashSet::stats().  A good hash function keeps chains short and the
+// average number of probes close to 1; a weak one shows up as a long tail
+// in the histogram and a maxChainLength that grows with the set.
 
+struct HashSetStats
+{
+    unsigned int buckets;
+    unsigned int elements;
+    double loadFactor;
+
+    // chainLengthHistogram[k] is the number of cells with exactly k
+    // elements in them.
+    std::vector<unsigned int> chainLengthHistogram;
+    unsigned int maxChainLength;
+
+    // Lookups made by contains() while lookup statistics were being
+    // collected, and the average number of nodes each one examined.
+    unsigned long long successfulLookups;
+    unsigned long long unsuccessfulLookups;
+    double averageSuccessfulProbes;
+    double averageUnsuccessfulProbes;
+
+    // The number of times the array has been resized (counting each
+    // incremental resize once), and the time spent doing it.
+    unsigned int resizes;
+    std::chrono::nanoseconds timeResizing;
+};
 
 
 
-template <typename ElementType>
+template <typename ElementType, typename Hasher = std::function<unsigned int(const ElementType&)>>
 class HashSet : public Set<ElementType>
 {
 public:
@@ -41,13 +86,41 @@ public:
     static constexpr unsigned int DEFAULT_CAPACITY = 10;
 
     // A HashFunction is a function that takes a reference to a const
-    // ElementType and returns an unsigned int.
+    // ElementType and returns an unsigned int.  It's the default Hasher,
+    // so a HashSet can be given any function or lambda that hashes its
+    // elements; a Hasher type whose calls can be inlined (such as the ones
+    // in StringHashers.hpp) can be given instead, as the second template
+    // argument, to avoid an indirect call for every hash.
     using HashFunction = std::function<unsigned int(const ElementType&)>;
 
+    // A HashValue is whatever type the Hasher returns, which needn't be
+    // as small as an unsigned int.
+    using HashValue = typename std::decay<decltype(
+        std::declval<const Hasher&>()(std::declval<const ElementType&>()))>::type;
+
+public:
+    // The number of cells of the old array that are moved into the new one
+    // during each call to add(), while an incremental resize is underway.
+    static constexpr unsigned int MIGRATION_STEP = 4;
+
 public:
     // Initializes a HashSet to be empty, so that it will use the given
-    // hash function whenever it needs to hash an element.
-    explicit HashSet(HashFunction hashFunction);
+    // hash function whenever it needs to hash an element.  If
+    // incrementalResize is true, resizing is spread across many calls
+    // to add() instead of happening all at once.
+    explicit HashSet(Hasher hashFunction, bool incrementalResize = false);
+
+    // Initializes a HashSet to contain the elements in the range [first,
+    // last), using the given hash function.  When the iterators are at
+    // least forward iterators, the array is allocated once, already big
+    // enough for every element in the range, so that no resizing happens
+    // while the elements are added.  If the caller knows the range
+    // contains no duplicates, passing true for elementsAreUnique skips
+    // checking each element against the set.  incrementalResize is as it
+    // is for the other constructor.
+    template <typename InputIterator>
+    HashSet(InputIterator first, InputIterator last, Hasher hashFunction,
+        bool elementsAreUnique = false, bool incrementalResize = false);
 
     // Cleans up the HashSet so that it leaks no memory.
     virtual ~HashSet() noexcept;
@@ -77,7 +150,8 @@ public:
     // where the array is resized, this function runs in linear time (with
     // respect to the number of elements, assuming a good hash function);
     // otherwise, it runs in constant time (again, assuming a good hash
-    // function).
+    // function).  When resizing incrementally, this function always runs in
+    // constant time, since each call only moves MIGRATION_STEP cells.
     virtual void add(const ElementType& element) override;
 
 
@@ -87,13 +161,32 @@ public:
     virtual bool contains(const ElementType& element) const override;
 
 
+    // containsKey() returns true if the set contains an element equal to
+    // the given key, which can be of some type other than ElementType (such
+    // as a std::string_view, when the elements are std::strings), so that
+    // looking it up doesn't require building an ElementType first.  The
+    // given keyHash function must hash each key to the same value that the
+    // set's hash function gives to an element equal to it.  It's taken by
+    // reference, so a hasher with state isn't copied for every lookup.
+    template <typename Key, typename KeyHashFunction>
+    bool containsKey(const Key& key, const KeyHashFunction& keyHash) const;
+
+    // This version of containsKey() hashes the key with the set's own
+    // Hasher, which must accept it, as the hashers in StringHashers.hpp
+    // accept a std::string_view.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept override;
 
 
     // elementsAtIndex() returns the number of elements that hashed to a
     // particular index in the array.  If the index is out of the boundaries
-    // of the array, this function returns 0.
+    // of the array, this function returns 0.  Elements still waiting to be
+    // moved by an incremental resize are counted at the index they'll be
+    // moved to.
     unsigned int elementsAtIndex(unsigned int index) const;
 
 
@@ -103,135 +196,361 @@ public:
     bool isElementAtIndex(const ElementType& element, unsigned int index) const;
 
 
+    // reserve() makes room for at least the given number of elements, so
+    // that adding that many won't trigger a resize.  It never shrinks the
+    // array.  If an incremental resize is underway, it's finished first.
+    void reserve(unsigned int elements);
+
+
+    // isResizing() returns true if an incremental resize has been started
+    // but not all of the old array's cells have been moved yet.
+    bool isResizing() const noexcept;
+
+
+    // stats() summarizes the current shape of the table, along with the
+    // lookup and resizing statistics collected so far.  It runs in linear
+    // time, since it visits every cell.
+    HashSetStats stats() const;
+
+
+    // collectLookupStats() turns the counting of lookups and probes on or
+    // off; it's off by default.  Resizes are always counted, and resizes
+    // done all at once are always timed, but the small steps of an
+    // incremental resize are only timed while this is on.  While
+    // lookups are being counted, contains() writes to the HashSet, so it
+    // is no longer safe for several threads to call it at once.
+    void collectLookupStats(bool enabled) noexcept;
+
+
+    // resetStats() sets the lookup and resizing statistics back to zero.
+    void resetStats() noexcept;
+
+
 private:
-    HashFunction hashFunction;
+    Hasher hashFunction;
+    // Each node remembers the full hash of its element, so that resizing
+    // never needs to call the hash function again and so that most
+    // mismatches in a chain are rejected without comparing elements.
     struct Node {
         ElementType data;
+        HashValue hash;
         Node* next;
     };
     unsigned int amountOfBuckets;
     unsigned int sz;
     Node** hashTable;
+    NodePool<Node> pool;
+    bool incremental;
+    // While an incremental resize is underway, oldHashTable is the array
+    // being drained; cells below migrateIndex have already been moved.
+    Node** oldHashTable;
+    unsigned int oldAmountOfBuckets;
+    unsigned int migrateIndex;
+    bool collectingLookups = false;
+    mutable unsigned long long successfulLookups = 0;
+    mutable unsigned long long successfulProbes = 0;
+    mutable unsigned long long unsuccessfulLookups = 0;
+    mutable unsigned long long unsuccessfulProbes = 0;
+    unsigned int resizes = 0;
+    std::chrono::nanoseconds timeResizing{0};
     double loadFactor() const;
+    static unsigned int bucketsFor(unsigned int elements, unsigned int buckets) noexcept;
+    template <typename InputIterator>
+    static unsigned int bucketsForRange(InputIterator first, InputIterator last);
+    void destroyNodes(Node** table, unsigned int buckets) noexcept;
+    void clear() noexcept;
+    void copyFrom(const HashSet& s);
+    void migrate(unsigned int cells);
+    void rehash(unsigned int newAmountOfBuckets);
+    void insertUnique(const ElementType& element, HashValue hash);
+    template <typename Key>
+    bool chainContains(Node* node, HashValue hash, const Key& element, unsigned int& probes) const;
+    template <typename Key>
+    bool containsHashed(const Key& element, HashValue hash, unsigned int& probes) const;
+    void recordLookup(bool found, unsigned int probes) const noexcept;
 };
 
 
 
-namespace impl_
+template <typename ElementType, typename Hasher>
+double HashSet<ElementType, Hasher>::loadFactor() const {
+    double retVal = 1.0 * sz / amountOfBuckets;
+    return retVal;
+}
+
+
+// destroyNodes() runs the destructors of all of the nodes in one of the
+// arrays, leaving their memory to be given back by the pool.
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::destroyNodes(Node** table, unsigned int buckets) noexcept
 {
-    template <typename ElementType>
-    unsigned int HashSet__undefinedHashFunction(const ElementType& element)
-    {
-        return 0;
+    for(unsigned int i=0; i < buckets; i++) {
+        for(Node* n = table[i]; n != nullptr; ) {
+            Node* next = n->next;
+            n->~Node();
+            n = next;
+        }
     }
 }
 
-template <typename ElementType>
-double HashSet<ElementType>::loadFactor() const {
-    double retVal = 1.0 * sz / amountOfBuckets;
-    return retVal;
+// clear() disposes of every node and both arrays.  When the nodes are
+// trivially destructible, the chains don't need to be walked at all.
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::clear() noexcept
+{
+    if(!NodePool<Node>::isTriviallyDestructible) {
+        destroyNodes(hashTable, amountOfBuckets);
+        if(oldHashTable != nullptr) {
+            destroyNodes(oldHashTable, oldAmountOfBuckets);
+        }
+    }
+    pool.release();
+    delete[] hashTable;
+    delete[] oldHashTable;
+    hashTable = nullptr;
+    oldHashTable = nullptr;
+}
+
+// copyFrom() fills an empty HashSet with copies of the nodes of another,
+// keeping the order of each chain.  Elements still waiting in the other
+// HashSet's old array are rehashed into place, so the copy never starts
+// out in the middle of a resize.
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::copyFrom(const HashSet& s)
+{
+    amountOfBuckets = s.amountOfBuckets;
+    hashTable = new Node*[amountOfBuckets];
+    for(unsigned int i=0; i < amountOfBuckets; i++) {
+        Node** tail = &hashTable[i];
+        for(Node* n = s.hashTable[i]; n != nullptr; n = n->next) {
+            *tail = pool.create(n->data, n->hash, nullptr);
+            tail = &(*tail)->next;
+        }
+        *tail = nullptr;
+    }
+    if(s.oldHashTable != nullptr) {
+        for(unsigned int i=s.migrateIndex; i < s.oldAmountOfBuckets; i++) {
+            for(Node* n = s.oldHashTable[i]; n != nullptr; n = n->next) {
+                unsigned int numberLocation = n->hash % amountOfBuckets;
+                hashTable[numberLocation] = pool.create(n->data, n->hash, hashTable[numberLocation]);
+            }
+        }
+    }
+    sz = s.sz;
+}
+
+// migrate() moves up to the given number of cells of the old array into
+// the new one, relinking the existing nodes rather than copying them, and
+// releases the old array once it's empty.
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::migrate(unsigned int cells)
+{
+    if(oldHashTable == nullptr) {
+        return;
+    }
+    // Reading the clock would cost more than moving a few cells, so the
+    // steps of an incremental resize are only timed while statistics are
+    // being collected.
+    std::chrono::steady_clock::time_point start;
+    if(collectingLookups) {
+        start = std::chrono::steady_clock::now();
+    }
+    while(oldHashTable != nullptr && cells > 0) {
+        Node* currentHeadNode = oldHashTable[migrateIndex];
+        while(currentHeadNode != nullptr) {
+            Node* next = currentHeadNode->next;
+            unsigned int numberLocation = currentHeadNode->hash % amountOfBuckets;
+            currentHeadNode->next = hashTable[numberLocation];
+            hashTable[numberLocation] = currentHeadNode;
+            currentHeadNode = next;
+        }
+        oldHashTable[migrateIndex] = nullptr;
+        migrateIndex++;
+        cells--;
+        if(migrateIndex == oldAmountOfBuckets) {
+            delete[] oldHashTable;
+            oldHashTable = nullptr;
+            oldAmountOfBuckets = 0;
+            migrateIndex = 0;
+        }
+    }
+    if(collectingLookups) {
+        timeResizing += std::chrono::steady_clock::now() - start;
+    }
+}
+
+// rehash() resizes the array all at once, splicing every node onto the
+// front of its new chain.  No nodes are allocated or freed and no
+// elements are copied or rehashed.
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::rehash(unsigned int newAmountOfBuckets)
+{
+    auto start = std::chrono::steady_clock::now();
+    unsigned int old_amountOfBuckets = amountOfBuckets;
+    amountOfBuckets = newAmountOfBuckets;
+    Node** hT = new Node*[amountOfBuckets];
+    for(unsigned int i=0; i < amountOfBuckets; i++) {
+        hT[i] = nullptr;
+    }
+    for(unsigned int i=0; i < old_amountOfBuckets; i++) {
+        Node* currentHeadNode = hashTable[i];
+        while(currentHeadNode != nullptr) {
+            Node* next = currentHeadNode->next;
+            unsigned int new_numberLocation = currentHeadNode->hash % amountOfBuckets;
+            currentHeadNode->next = hT[new_numberLocation];
+            hT[new_numberLocation] = currentHeadNode;
+            currentHeadNode = next;
+        }
+    }
+    delete[] hashTable;
+    hashTable = hT;
+    resizes += 1;
+    timeResizing += std::chrono::steady_clock::now() - start;
+}
+
+template <typename ElementType, typename Hasher>
+template <typename Key>
+bool HashSet<ElementType, Hasher>::chainContains(Node* node, HashValue hash, const Key& element, unsigned int& probes) const
+{
+    while(node != nullptr) {
+        probes++;
+        if(node->hash == hash && node->data == element) {
+            return true;
+        }
+        node = node->next;
+    }
+    return false;
 }
 
 
 // Initializes a HashSet to be empty, so that it will use the given
 // hash function whenever it needs to hash an element.
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashFunction hashFunction)
-    : hashFunction{hashFunction}
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::HashSet(Hasher hashFunction, bool incrementalResize)
+    : hashFunction{hashFunction}, incremental{incrementalResize},
+      oldHashTable{nullptr}, oldAmountOfBuckets{0}, migrateIndex{0}
 {
     hashTable = new Node*[DEFAULT_CAPACITY];
     amountOfBuckets = DEFAULT_CAPACITY;
     sz = 0;
-    for(int i=0; i < amountOfBuckets; i++) {
+    for(unsigned int i=0; i < amountOfBuckets; i++) {
         hashTable[i] = nullptr;
     }
 }
 
-// Cleans up the HashSet so that it leaks no memory.
-template <typename ElementType>
-HashSet<ElementType>::~HashSet() noexcept
-{
-    for(int i=0; i < amountOfBuckets; i++) {
-        while(hashTable[i] != nullptr) {
-            Node* currentHeadNode = hashTable[i];
-            hashTable[i] = currentHeadNode->next;
-            delete currentHeadNode;
+template <typename ElementType, typename Hasher>
+template <typename InputIterator>
+HashSet<ElementType, Hasher>::HashSet(InputIterator first, InputIterator last, Hasher hashFunction,
+    bool elementsAreUnique, bool incrementalResize)
+    : hashFunction{hashFunction}, amountOfBuckets{bucketsForRange(first, last)}, sz{0},
+      hashTable{nullptr}, incremental{incrementalResize},
+      oldHashTable{nullptr}, oldAmountOfBuckets{0}, migrateIndex{0}
+{
+    hashTable = new Node*[amountOfBuckets];
+    for(unsigned int i=0; i < amountOfBuckets; i++) {
+        hashTable[i] = nullptr;
+    }
+
+    try {
+        for(; first != last; ++first) {
+            HashValue hash = hashFunction(*first);
+            unsigned int probes = 0;
+            if(elementsAreUnique || containsHashed(*first, hash, probes) == false) {
+                insertUnique(*first, hash);
+            }
         }
     }
-    delete[] hashTable;
+    catch(...) {
+        clear();
+        throw;
+    }
+}
+
+// Cleans up the HashSet so that it leaks no memory.
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::~HashSet() noexcept
+{
+    clear();
 }
 
 // Initializes a new HashSet to be a copy of an existing one.
-template <typename ElementType>
-HashSet<ElementType>::HashSet(const HashSet& s)
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::HashSet(const HashSet& s)
+    : hashFunction{s.hashFunction}, incremental{s.incremental},
+      oldHashTable{nullptr}, oldAmountOfBuckets{0}, migrateIndex{0}
 {
-    hashFunction = s.hashFunction;
-    hashTable = new Node*[s.amountOfBuckets];
-    amountOfBuckets = s.amountOfBuckets;
-    sz = s.sz;
-    for(int i=0; i < s.amountOfBuckets; i++) {
-        hashTable[i] = s.hashTable[i];
-    }
+    copyFrom(s);
 }
 
 // Assigns an expiring HashSet into another.
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashSet&& s) noexcept
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::HashSet(HashSet&& s) noexcept
+    : hashFunction{s.hashFunction},
+      incremental{false}, oldHashTable{nullptr}, oldAmountOfBuckets{0}, migrateIndex{0}
 {
     amountOfBuckets = DEFAULT_CAPACITY;
     hashTable = new Node*[amountOfBuckets];
-    for(int i=0; i < amountOfBuckets; i++) {
+    for(unsigned int i=0; i < amountOfBuckets; i++) {
         hashTable[i] = nullptr;
     }
+    sz = 0;
     std::swap(sz, s.sz);
     std::swap(hashTable, s.hashTable);
     std::swap(amountOfBuckets, s.amountOfBuckets);
     std::swap(hashFunction, s.hashFunction);
+    std::swap(incremental, s.incremental);
+    std::swap(oldHashTable, s.oldHashTable);
+    std::swap(oldAmountOfBuckets, s.oldAmountOfBuckets);
+    std::swap(migrateIndex, s.migrateIndex);
+    std::swap(pool, s.pool);
+    std::swap(collectingLookups, s.collectingLookups);
+    std::swap(successfulLookups, s.successfulLookups);
+    std::swap(successfulProbes, s.successfulProbes);
+    std::swap(unsuccessfulLookups, s.unsuccessfulLookups);
+    std::swap(unsuccessfulProbes, s.unsuccessfulProbes);
+    std::swap(resizes, s.resizes);
+    std::swap(timeResizing, s.timeResizing);
 }
 
 // Assigns an existing HashSet into another.
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>& HashSet<ElementType, Hasher>::operator=(const HashSet& s)
 {
     if(this != &s) {
-        Node **hT = new Node*[s.amountOfBuckets];
-        for(int i=0; i < s.amountOfBuckets; i++) {
-            hT[i] = s.hashTable[i];
-        }
-        hashFunction = s.hashFunction;
-        sz = s.sz;
-        for(int i=0; i < amountOfBuckets; i++) {
-            while(hashTable[i] != nullptr) {
-                Node* currentHeadNode = hashTable[i];
-                hashTable[i] = currentHeadNode->next;
-                delete currentHeadNode;
-            }
-        }
-        delete[] hashTable;
-        hashTable = hT;
-        amountOfBuckets = s.amountOfBuckets;
+        HashSet copy{s};
+        *this = std::move(copy);
     }
     return *this;
 }
 
 // Assigns an expiring HashSet into another.
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>& HashSet<ElementType, Hasher>::operator=(HashSet&& s) noexcept
 {
     if(this != &s) {
         std::swap(hashTable, s.hashTable);
         std::swap(hashFunction,s.hashFunction);
         std::swap(sz,s.sz);
         std::swap(amountOfBuckets, s.amountOfBuckets);
+        std::swap(incremental, s.incremental);
+        std::swap(oldHashTable, s.oldHashTable);
+        std::swap(oldAmountOfBuckets, s.oldAmountOfBuckets);
+        std::swap(migrateIndex, s.migrateIndex);
+        std::swap(pool, s.pool);
+        std::swap(collectingLookups, s.collectingLookups);
+        std::swap(successfulLookups, s.successfulLookups);
+        std::swap(successfulProbes, s.successfulProbes);
+        std::swap(unsuccessfulLookups, s.unsuccessfulLookups);
+        std::swap(unsuccessfulProbes, s.unsuccessfulProbes);
+        std::swap(resizes, s.resizes);
+        std::swap(timeResizing, s.timeResizing);
     }
     return *this;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::isImplemented() const noexcept
 {
     return true;
 }
@@ -243,84 +562,113 @@ bool HashSet<ElementType>::isImplemented() const noexcept
 // respect to the number of elements, assuming a good hash function);
 // otherwise, it runs in constant time (again, assuming a good hash
 // function).
-template <typename ElementType>
-void HashSet<ElementType>::add(const ElementType& element)
-{
-    if(contains(element) == false) {
-        unsigned int numberLocation = hashFunction(element) % amountOfBuckets;
-        Node* headNode = hashTable[numberLocation];
-        Node* newNode = new Node();
-        newNode->data = element;
-        newNode->next = nullptr;
-        if(headNode == nullptr) {
-            hashTable[numberLocation] = newNode;
-        }
-        else {
-            while(headNode->next != nullptr) {
-                headNode = headNode->next;
-            }
-            headNode->next = newNode;
-        }
-        sz += 1;
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::add(const ElementType& element)
+{
+    HashValue hash = hashFunction(element);
+    unsigned int probes = 0;
+    if(containsHashed(element, hash, probes) == false) {
+        insertUnique(element, hash);
+    }
+}
+
+// insertUnique() adds an element known not to be in the set, resizing
+// afterward if needed.
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::insertUnique(const ElementType& element, HashValue hash)
+{
+    unsigned int numberLocation = hash % amountOfBuckets;
+    hashTable[numberLocation] = pool.create(element, hash, hashTable[numberLocation]);
+    sz += 1;
+    if(incremental) {
+        migrate(MIGRATION_STEP);
         if(loadFactor() > 0.8) {
-            unsigned int old_amountOfBuckets = amountOfBuckets;
+            // The previous resize has to be finished before another can
+            // start; with MIGRATION_STEP of at least 2, it always is.
+            migrate(oldAmountOfBuckets);
+            resizes += 1;
+            oldHashTable = hashTable;
+            oldAmountOfBuckets = amountOfBuckets;
+            migrateIndex = 0;
             amountOfBuckets = amountOfBuckets * 2;
-            Node** hT = new Node*[amountOfBuckets];
-            for(int i=0; i < amountOfBuckets; i++) {
-                hT[i] = nullptr;
+            hashTable = new Node*[amountOfBuckets];
+            for(unsigned int i=0; i < amountOfBuckets; i++) {
+                hashTable[i] = nullptr;
             }
-            for(int i=0; i < old_amountOfBuckets; i++) {
-                Node* currentHeadNode = hashTable[i];
-                while(currentHeadNode != nullptr) {
-                    unsigned int new_numberLocation = hashFunction(currentHeadNode->data) % amountOfBuckets;
-                    Node* new_headNode = hT[new_numberLocation];
-                    Node* new_newNode = new Node();
-                    new_newNode->data = currentHeadNode->data;
-                    new_newNode->next = nullptr;
-                    if(new_headNode == nullptr) {
-                        hT[new_numberLocation] = new_newNode;
-                    }
-                    else {
-                        while(new_headNode->next != nullptr) {
-                            new_headNode = new_headNode->next;
-                        }
-                        new_headNode->next = new_newNode;
-                    }
-                    currentHeadNode = currentHeadNode->next;
-                }
-            }
-            for(int i=0; i < old_amountOfBuckets; i++) {
-                while(hashTable[i] != nullptr) {
-                    Node* currentHeadNode = hashTable[i];
-                    hashTable[i] = currentHeadNode->next;
-                    delete currentHeadNode;
-                }
-            }
-            delete[] hashTable;
-            hashTable = hT;
+            migrate(MIGRATION_STEP);
         }
     }
+    else if(loadFactor() > 0.8) {
+        rehash(amountOfBuckets * 2);
+    }
 }
 
 // contains() returns true if the given element is already in the set,
 // false otherwise.  This function runs in constant time (with respect
 // to the number of elements, assuming a good hash function).
-template <typename ElementType>
-bool HashSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::contains(const ElementType& element) const
 {
-    Node* currentHeadNode = hashTable[hashFunction(element) % amountOfBuckets];
-    while(currentHeadNode != nullptr) {
-        if(currentHeadNode->data == element) {
-            return true;
-        }
-        currentHeadNode = currentHeadNode->next;
+    unsigned int probes = 0;
+    bool found = containsHashed(element, hashFunction(element), probes);
+    if(collectingLookups) {
+        recordLookup(found, probes);
+    }
+    return found;
+}
+
+template <typename ElementType, typename Hasher>
+template <typename Key, typename KeyHashFunction>
+bool HashSet<ElementType, Hasher>::containsKey(const Key& key, const KeyHashFunction& keyHash) const
+{
+    unsigned int probes = 0;
+    bool found = containsHashed(key, static_cast<HashValue>(keyHash(key)), probes);
+    if(collectingLookups) {
+        recordLookup(found, probes);
+    }
+    return found;
+}
+
+template <typename ElementType, typename Hasher>
+template <typename Key>
+bool HashSet<ElementType, Hasher>::containsKey(const Key& key) const
+{
+    return containsKey(key, hashFunction);
+}
+
+// While an incremental resize is underway, the element may still be in a
+// cell of the old array that hasn't been moved yet, so that cell is
+// checked, too.
+template <typename ElementType, typename Hasher>
+template <typename Key>
+bool HashSet<ElementType, Hasher>::containsHashed(const Key& element, HashValue hash, unsigned int& probes) const
+{
+    if(chainContains(hashTable[hash % amountOfBuckets], hash, element, probes)) {
+        return true;
+    }
+    if(oldHashTable != nullptr) {
+        unsigned int oldLocation = hash % oldAmountOfBuckets;
+        return oldLocation >= migrateIndex && chainContains(oldHashTable[oldLocation], hash, element, probes);
     }
     return false;
 }
 
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::recordLookup(bool found, unsigned int probes) const noexcept
+{
+    if(found) {
+        successfulLookups++;
+        successfulProbes += probes;
+    }
+    else {
+        unsuccessfulLookups++;
+        unsuccessfulProbes += probes;
+    }
+}
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::size() const noexcept
+
+template <typename ElementType, typename Hasher>
+unsigned int HashSet<ElementType, Hasher>::size() const noexcept
 {
     return sz;
 }
@@ -328,10 +676,10 @@ unsigned int HashSet<ElementType>::size() const noexcept
 // elementsAtIndex() returns the number of elements that hashed to a
 // particular index in the array.  If the index is out of the boundaries
 // of the array, this function returns 0.
-template <typename ElementType>
-unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
+template <typename ElementType, typename Hasher>
+unsigned int HashSet<ElementType, Hasher>::elementsAtIndex(unsigned int index) const
 {
-    if(index < 0 || index >= amountOfBuckets) {
+    if(index >= amountOfBuckets) {
         return 0;
     }
     else {
@@ -341,6 +689,17 @@ unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
             returnValue++;
             temp_currentNode = temp_currentNode->next;
         }
+        // Since the array exactly doubled, everything that will land at
+        // this index is waiting in the same old cell.
+        if(oldHashTable != nullptr && index % oldAmountOfBuckets >= migrateIndex) {
+            temp_currentNode = oldHashTable[index % oldAmountOfBuckets];
+            while(temp_currentNode != nullptr) {
+                if(temp_currentNode->hash % amountOfBuckets == index) {
+                    returnValue++;
+                }
+                temp_currentNode = temp_currentNode->next;
+            }
+        }
         return returnValue;
     }
 }
@@ -348,25 +707,121 @@ unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
 // isElementAtIndex() returns true if the given element hashed to a
 // particular index in the array, false otherwise.  If the index is
 // out of the boundaries of the array, this functions returns 0.
-template <typename ElementType>
-bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned int index) const
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::isElementAtIndex(const ElementType& element, unsigned int index) const
 {
-    if(index < 0 || index > amountOfBuckets) {
+    if(index >= amountOfBuckets) {
         return 0;
     }
+    HashValue hash = hashFunction(element);
+    unsigned int probes = 0;
+    if(chainContains(hashTable[index], hash, element, probes)) {
+        return true;
+    }
+    else if(oldHashTable != nullptr && index % oldAmountOfBuckets >= migrateIndex) {
+        return hash % amountOfBuckets == index
+            && chainContains(oldHashTable[index % oldAmountOfBuckets], hash, element, probes);
+    }
     else {
-        Node* temp_currentNode = hashTable[index];
-        while(temp_currentNode != nullptr) {
-            if(temp_currentNode->data == element) {
-                return true;
-            }
-            temp_currentNode = temp_currentNode->next;
-        }
         return false;
     }
 }
 
 
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::reserve(unsigned int elements)
+{
+    migrate(oldAmountOfBuckets);
+    unsigned int newAmountOfBuckets = bucketsFor(elements, amountOfBuckets);
+    if(newAmountOfBuckets != amountOfBuckets) {
+        rehash(newAmountOfBuckets);
+    }
+}
 
-#endif // HASHSET_HPP
 
+// bucketsFor() doubles the given number of cells until the given number
+// of elements fit in them without the load factor going over 0.8.
+template <typename ElementType, typename Hasher>
+unsigned int HashSet<ElementType, Hasher>::bucketsFor(unsigned int elements, unsigned int buckets) noexcept
+{
+    while(elements > 0.8 * buckets && buckets <= std::numeric_limits<unsigned int>::max() / 2) {
+        buckets = buckets * 2;
+    }
+    return buckets;
+}
+
+
+// bucketsForRange() is the size of the array that the range constructor
+// allocates: enough for every element in the range, when it can be
+// counted without consuming it, or DEFAULT_CAPACITY otherwise.
+template <typename ElementType, typename Hasher>
+template <typename InputIterator>
+unsigned int HashSet<ElementType, Hasher>::bucketsForRange(InputIterator first, InputIterator last)
+{
+    using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+    if constexpr(std::is_base_of<std::forward_iterator_tag, Category>::value) {
+        return bucketsFor(static_cast<unsigned int>(std::distance(first, last)), DEFAULT_CAPACITY);
+    }
+    else {
+        return DEFAULT_CAPACITY;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::isResizing() const noexcept
+{
+    return oldHashTable != nullptr;
+}
+
+
+
+template <typename ElementType, typename Hasher>
+HashSetStats HashSet<ElementType, Hasher>::stats() const
+{
+    HashSetStats stats;
+    stats.buckets = amountOfBuckets;
+    stats.elements = sz;
+    stats.loadFactor = loadFactor();
+    stats.maxChainLength = 0;
+    for(unsigned int i=0; i < amountOfBuckets; i++) {
+        unsigned int length = elementsAtIndex(i);
+        if(length >= stats.chainLengthHistogram.size()) {
+            stats.chainLengthHistogram.resize(length + 1, 0);
+        }
+        stats.chainLengthHistogram[length]++;
+        stats.maxChainLength = length > stats.maxChainLength ? length : stats.maxChainLength;
+    }
+    stats.successfulLookups = successfulLookups;
+    stats.unsuccessfulLookups = unsuccessfulLookups;
+    stats.averageSuccessfulProbes =
+        successfulLookups == 0 ? 0.0 : 1.0 * successfulProbes / successfulLookups;
+    stats.averageUnsuccessfulProbes =
+        unsuccessfulLookups == 0 ? 0.0 : 1.0 * unsuccessfulProbes / unsuccessfulLookups;
+    stats.resizes = resizes;
+    stats.timeResizing = timeResizing;
+    return stats;
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::collectLookupStats(bool enabled) noexcept
+{
+    collectingLookups = enabled;
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::resetStats() noexcept
+{
+    successfulLookups = 0;
+    successfulProbes = 0;
+    unsuccessfulLookups = 0;
+    unsuccessfulProbes = 0;
+    resizes = 0;
+    timeResizing = std::chrono::nanoseconds{0};
+}
+
+
+
+#endif // HASHSET_HPP
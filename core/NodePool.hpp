@@ -0,0 +1,269 @@
+// NodePool.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A NodePool hands out memory for the nodes of a linked data structure
+// (the chains of a HashSet, the tree of an AVLSet, the levels of a
+// SkipListSet) from a small number of large, contiguous chunks, rather than
+// making one trip to the heap for every node.  Each chunk is twice as large
+// as the one before it, up to a limit, so a structure with n nodes makes
+// only O(log n) allocations until it gets very large.
+//
+// Nodes that are destroyed individually are kept on a free list and reused
+// by later calls to create().  A structure that is throwing all of its
+// nodes away at once can instead call release(), which gives all of the
+// chunks back to the heap without visiting the nodes; when the nodes are
+// trivially destructible, that's all that needs to happen, so tearing
+// down the structure costs O(chunks) rather than O(nodes).
+//
+// A NodePool cannot be copied, since nodes can't be moved without fixing
+// up the pointers to them; a copy of a structure builds its own pool.
+
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+
+template <typename Node>
+class NodePool
+{
+public:
+    // The number of nodes in the first chunk, and the most nodes any
+    // one chunk will hold.
+    static constexpr unsigned int FIRST_CHUNK_CAPACITY = 32;
+    static constexpr unsigned int MAX_CHUNK_CAPACITY = 8192;
+
+    // isTriviallyDestructible is true when release() alone is enough to
+    // dispose of every node in the pool.
+    static constexpr bool isTriviallyDestructible = std::is_trivially_destructible<Node>::value;
+
+public:
+    NodePool() noexcept;
+    ~NodePool() noexcept;
+
+    NodePool(const NodePool& p) = delete;
+    NodePool& operator=(const NodePool& p) = delete;
+
+    NodePool(NodePool&& p) noexcept;
+    NodePool& operator=(NodePool&& p) noexcept;
+
+
+    // create() constructs a new node from the given arguments, in memory
+    // taken from the free list if possible and from the newest chunk
+    // otherwise.
+    template <typename... Args>
+    Node* create(Args&&... args);
+
+
+    // destroy() runs the destructor of a node that came from this pool and
+    // puts its memory on the free list.
+    void destroy(Node* node) noexcept;
+
+
+    // release() gives every chunk back to the heap.  It does not run the
+    // destructors of any nodes still in use; unless isTriviallyDestructible
+    // is true, the caller is responsible for having done that first.
+    void release() noexcept;
+
+
+    // absorb() takes over all of the chunks and free nodes of another pool,
+    // leaving it empty, so that nodes created by the other pool can be
+    // destroyed by this one.  This lets several threads each build nodes
+    // in a pool of their own and then hand them over to one structure.
+    // The unused part of the other pool's newest chunk isn't reused, but
+    // is given back to the heap along with the rest.
+    void absorb(NodePool&& p) noexcept;
+
+
+    // chunkCount() returns the number of chunks currently allocated.
+    unsigned int chunkCount() const noexcept;
+
+
+private:
+    union Slot {
+        Slot* nextFree;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    struct Chunk {
+        Chunk* next;
+        Slot* slots;
+        unsigned int capacity;
+    };
+
+    Chunk* chunks;
+    Slot* freeList;
+    unsigned int used;
+    unsigned int chunks_sz;
+
+    Slot* allocateSlot();
+};
+
+
+
+template <typename Node>
+NodePool<Node>::NodePool() noexcept
+    : chunks{nullptr}, freeList{nullptr}, used{0}, chunks_sz{0}
+{
+}
+
+
+template <typename Node>
+NodePool<Node>::~NodePool() noexcept
+{
+    release();
+}
+
+
+template <typename Node>
+NodePool<Node>::NodePool(NodePool&& p) noexcept
+    : chunks{nullptr}, freeList{nullptr}, used{0}, chunks_sz{0}
+{
+    std::swap(chunks, p.chunks);
+    std::swap(freeList, p.freeList);
+    std::swap(used, p.used);
+    std::swap(chunks_sz, p.chunks_sz);
+}
+
+
+template <typename Node>
+NodePool<Node>& NodePool<Node>::operator=(NodePool&& p) noexcept
+{
+    if(this != &p) {
+        std::swap(chunks, p.chunks);
+        std::swap(freeList, p.freeList);
+        std::swap(used, p.used);
+        std::swap(chunks_sz, p.chunks_sz);
+    }
+    return *this;
+}
+
+
+template <typename Node>
+typename NodePool<Node>::Slot* NodePool<Node>::allocateSlot()
+{
+    if(freeList != nullptr) {
+        Slot* slot = freeList;
+        freeList = slot->nextFree;
+        return slot;
+    }
+    if(chunks == nullptr || used == chunks->capacity) {
+        unsigned int capacity = FIRST_CHUNK_CAPACITY;
+        if(chunks != nullptr && chunks->capacity < MAX_CHUNK_CAPACITY) {
+            capacity = chunks->capacity * 2;
+        }
+        else if(chunks != nullptr) {
+            capacity = MAX_CHUNK_CAPACITY;
+        }
+        Chunk* chunk = new Chunk{chunks, nullptr, capacity};
+        try {
+            chunk->slots = new Slot[capacity];
+        }
+        catch(...) {
+            delete chunk;
+            throw;
+        }
+        chunks = chunk;
+        used = 0;
+        chunks_sz += 1;
+    }
+    return &chunks->slots[used++];
+}
+
+
+template <typename Node>
+template <typename... Args>
+Node* NodePool<Node>::create(Args&&... args)
+{
+    Slot* slot = allocateSlot();
+    try {
+        return new (slot->storage) Node{std::forward<Args>(args)...};
+    }
+    catch(...) {
+        slot->nextFree = freeList;
+        freeList = slot;
+        throw;
+    }
+}
+
+
+template <typename Node>
+void NodePool<Node>::destroy(Node* node) noexcept
+{
+    node->~Node();
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->nextFree = freeList;
+    freeList = slot;
+}
+
+
+template <typename Node>
+void NodePool<Node>::release() noexcept
+{
+    while(chunks != nullptr) {
+        Chunk* next = chunks->next;
+        delete[] chunks->slots;
+        delete chunks;
+        chunks = next;
+    }
+    freeList = nullptr;
+    used = 0;
+    chunks_sz = 0;
+}
+
+
+// The absorbed chunks go at the end of the list of chunks, since create()
+// only hands out never-used slots from the chunk at the front.
+template <typename Node>
+void NodePool<Node>::absorb(NodePool&& p) noexcept
+{
+    if(this == &p) {
+        return;
+    }
+
+    if(p.chunks != nullptr) {
+        if(chunks == nullptr) {
+            chunks = p.chunks;
+            used = p.used;
+        }
+        else {
+            Chunk* tail = chunks;
+            while(tail->next != nullptr) {
+                tail = tail->next;
+            }
+            tail->next = p.chunks;
+        }
+        chunks_sz += p.chunks_sz;
+    }
+
+    if(p.freeList != nullptr) {
+        Slot* tail = p.freeList;
+        while(tail->nextFree != nullptr) {
+            tail = tail->nextFree;
+        }
+        tail->nextFree = freeList;
+        freeList = p.freeList;
+    }
+
+    p.chunks = nullptr;
+    p.freeList = nullptr;
+    p.used = 0;
+    p.chunks_sz = 0;
+}
+
+
+template <typename Node>
+unsigned int NodePool<Node>::chunkCount() const noexcept
+{
+    return chunks_sz;
+}
+
+
+
+#endif // NODEPOOL_HPP
+
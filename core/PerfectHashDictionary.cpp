@@ -0,0 +1,390 @@
+// PerfectHashDictionary.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Implementation of PerfectHashDictionary and of the builder that writes
+// its files.
+
+#include "PerfectHashDictionary.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "StringHashers.hpp"
+
+
+namespace
+{
+    constexpr char MAGIC[8] = {'M', 'P', 'H', 'D', 'I', 'C', 'T', '1'};
+
+    // The average number of words per bucket.  Larger buckets make the
+    // file smaller but make good pilots harder to find.
+    constexpr std::uint32_t WORDS_PER_BUCKET = 3;
+
+    // How many pilots are tried for one bucket, and how many seeds are
+    // tried for the whole dictionary, before giving up.
+    constexpr std::uint32_t MAX_PILOT = 1u << 22;
+    constexpr unsigned int MAX_SEEDS = 32;
+
+    struct Header
+    {
+        char magic[8];
+        std::uint64_t seed;
+        std::uint32_t count;
+        std::uint32_t bucketCount;
+        std::uint64_t blobSize;
+    };
+
+
+    std::uint64_t hashWord(std::string_view word, std::uint64_t seed)
+    {
+        return WyStringHash{seed}(word);
+    }
+
+
+    std::uint32_t bucketOf(std::uint64_t hash, std::uint32_t bucketCount)
+    {
+        return static_cast<std::uint32_t>(((hash >> 32) * bucketCount) >> 32);
+    }
+
+
+    std::uint32_t slotOf(std::uint64_t hash, std::uint32_t pilot, std::uint64_t seed, std::uint32_t count)
+    {
+        std::uint64_t displacement = impl_::stringHashMix(pilot ^ 0x9e3779b97f4a7c15ull, seed ^ 0xbf58476d1ce4e5b9ull);
+        return static_cast<std::uint32_t>((hash ^ displacement) % count);
+    }
+
+
+    // findPilots() tries to choose a pilot for every bucket so that all of
+    // the words land in different slots, filling in slotWords with the
+    // index of the word in each slot.  Buckets are placed largest first,
+    // while the table is still mostly empty.
+    bool findPilots(
+        const std::vector<std::string>& words, std::uint64_t seed, std::uint32_t bucketCount,
+        std::vector<std::uint32_t>& pilots, std::vector<std::uint32_t>& slotWords)
+    {
+        std::uint32_t count = static_cast<std::uint32_t>(words.size());
+        std::vector<std::uint64_t> hashes(count);
+        std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+        for(std::uint32_t i=0; i < count; i++) {
+            hashes[i] = hashWord(words[i], seed);
+            buckets[bucketOf(hashes[i], bucketCount)].push_back(i);
+        }
+
+        std::vector<std::uint32_t> order(bucketCount);
+        for(std::uint32_t b=0; b < bucketCount; b++) {
+            order[b] = b;
+        }
+        std::stable_sort(order.begin(), order.end(),
+            [&](std::uint32_t a, std::uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        std::vector<bool> taken(count, false);
+        std::vector<std::uint32_t> slots;
+        pilots.assign(bucketCount, 0);
+        slotWords.assign(count, 0);
+
+        for(std::uint32_t b : order) {
+            const std::vector<std::uint32_t>& bucket = buckets[b];
+            if(bucket.empty()) {
+                break;
+            }
+
+            bool placed = false;
+            for(std::uint32_t pilot=0; pilot < MAX_PILOT && !placed; pilot++) {
+                slots.clear();
+                placed = true;
+                for(std::uint32_t word : bucket) {
+                    std::uint32_t slot = slotOf(hashes[word], pilot, seed, count);
+                    if(taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                        placed = false;
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if(placed) {
+                    pilots[b] = pilot;
+                    for(std::size_t i=0; i < bucket.size(); i++) {
+                        taken[slots[i]] = true;
+                        slotWords[slots[i]] = bucket[i];
+                    }
+                }
+            }
+
+            if(!placed) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    // writeRaw() writes all of the given data to a file descriptor,
+    // returning false if any of it couldn't be written.
+    bool writeRaw(int fd, const void* data, std::size_t size)
+    {
+        const char* p = static_cast<const char*>(data);
+        while(size > 0) {
+            ssize_t written = ::write(fd, p, size);
+            if(written < 0 && errno == EINTR) {
+                continue;
+            }
+            else if(written <= 0) {
+                return false;
+            }
+            p += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+}
+
+
+
+PerfectHashDictionaryException::PerfectHashDictionaryException(const std::string& reason)
+    : reason_{reason}
+{
+}
+
+
+const std::string& PerfectHashDictionaryException::reason() const
+{
+    return reason_;
+}
+
+
+
+void writePerfectHashDictionary(const std::vector<std::string>& words, const std::string& path)
+{
+    std::vector<std::string> unique{words};
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    if(unique.size() > 0xFFFFFFFFu) {
+        throw PerfectHashDictionaryException{"too many words for a dictionary file"};
+    }
+
+    std::uint32_t count = static_cast<std::uint32_t>(unique.size());
+    std::uint32_t bucketCount = count / WORDS_PER_BUCKET + 1;
+    std::vector<std::uint32_t> pilots;
+    std::vector<std::uint32_t> slotWords;
+
+    std::uint64_t seed = 0;
+    bool built = false;
+    for(unsigned int attempt=0; attempt < MAX_SEEDS && !built; attempt++) {
+        seed = impl_::stringHashMix(attempt, 0xa0761d6478bd642full);
+        built = findPilots(unique, seed, bucketCount, pilots, slotWords);
+    }
+    if(!built) {
+        throw PerfectHashDictionaryException{"could not find a perfect hash function for the words"};
+    }
+
+    std::vector<std::uint32_t> offsets(count + 1);
+    std::uint64_t blobSize = 0;
+    for(std::uint32_t slot=0; slot < count; slot++) {
+        offsets[slot] = static_cast<std::uint32_t>(blobSize);
+        blobSize += unique[slotWords[slot]].size();
+        if(blobSize > 0xFFFFFFFFu) {
+            throw PerfectHashDictionaryException{"too much text for a dictionary file"};
+        }
+    }
+    offsets[count] = static_cast<std::uint32_t>(blobSize);
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.seed = seed;
+    header.count = count;
+    header.bucketCount = bucketCount;
+    header.blobSize = blobSize;
+
+    // Processes may have the existing file mapped, and truncating it would
+    // pull the pages out from under them.  So the new file is written
+    // alongside it and then renamed over it, which leaves their mappings
+    // of the old file intact.
+    std::string temporaryPath = path + ".XXXXXX";
+    int fd = ::mkstemp(&temporaryPath[0]);
+    if(fd < 0) {
+        throw PerfectHashDictionaryException{"could not create a temporary file next to " + path};
+    }
+
+    bool written = ::fchmod(fd, 0644) == 0
+        && writeRaw(fd, &header, sizeof(Header))
+        && writeRaw(fd, pilots.data(), sizeof(std::uint32_t) * pilots.size())
+        && writeRaw(fd, offsets.data(), sizeof(std::uint32_t) * offsets.size());
+    for(std::uint32_t slot=0; slot < count && written; slot++) {
+        const std::string& word = unique[slotWords[slot]];
+        written = writeRaw(fd, word.data(), word.size());
+    }
+    written = ::fsync(fd) == 0 && written;
+    written = ::close(fd) == 0 && written;
+
+    if(!written || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        throw PerfectHashDictionaryException{"could not write " + path};
+    }
+}
+
+
+
+PerfectHashDictionary::PerfectHashDictionary(const std::string& path)
+    : path{path}, mapping{nullptr}, mappingSize{0}
+{
+    map();
+}
+
+
+PerfectHashDictionary::~PerfectHashDictionary() noexcept
+{
+    unmap();
+}
+
+
+PerfectHashDictionary::PerfectHashDictionary(const PerfectHashDictionary& d)
+    : path{d.path}, mapping{nullptr}, mappingSize{0}
+{
+    map();
+}
+
+
+PerfectHashDictionary::PerfectHashDictionary(PerfectHashDictionary&& d) noexcept
+    : path{std::move(d.path)}, mapping{d.mapping}, mappingSize{d.mappingSize},
+      seed{d.seed}, count{d.count}, bucketCount{d.bucketCount},
+      pilots{d.pilots}, offsets{d.offsets}, blob{d.blob}, blobSize{d.blobSize}
+{
+    d.mapping = nullptr;
+    d.mappingSize = 0;
+    d.count = 0;
+}
+
+
+PerfectHashDictionary& PerfectHashDictionary::operator=(const PerfectHashDictionary& d)
+{
+    if(this != &d) {
+        PerfectHashDictionary copy{d};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+PerfectHashDictionary& PerfectHashDictionary::operator=(PerfectHashDictionary&& d) noexcept
+{
+    if(this != &d) {
+        std::swap(path, d.path);
+        std::swap(mapping, d.mapping);
+        std::swap(mappingSize, d.mappingSize);
+        std::swap(seed, d.seed);
+        std::swap(count, d.count);
+        std::swap(bucketCount, d.bucketCount);
+        std::swap(pilots, d.pilots);
+        std::swap(offsets, d.offsets);
+        std::swap(blob, d.blob);
+        std::swap(blobSize, d.blobSize);
+    }
+    return *this;
+}
+
+
+bool PerfectHashDictionary::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void PerfectHashDictionary::add(const std::string&)
+{
+    throw PerfectHashDictionaryException{"a perfect hash dictionary is read-only"};
+}
+
+
+bool PerfectHashDictionary::contains(const std::string& element) const
+{
+    return containsKey(element);
+}
+
+
+bool PerfectHashDictionary::containsKey(std::string_view word) const
+{
+    if(count == 0) {
+        return false;
+    }
+
+    std::uint64_t hash = hashWord(word, seed);
+    std::uint32_t slot = slotOf(hash, pilots[bucketOf(hash, bucketCount)], seed, count);
+    std::uint32_t start = offsets[slot];
+    std::uint32_t end = offsets[slot + 1];
+    if(start > end || end > blobSize) {
+        return false;
+    }
+    return word == std::string_view{blob + start, end - start};
+}
+
+
+unsigned int PerfectHashDictionary::size() const noexcept
+{
+    return count;
+}
+
+
+void PerfectHashDictionary::map()
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw PerfectHashDictionaryException{"could not open " + path};
+    }
+
+    struct stat info;
+    if(::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw PerfectHashDictionaryException{path + " is not a dictionary file"};
+    }
+
+    mappingSize = static_cast<std::size_t>(info.st_size);
+    mapping = ::mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mapping == MAP_FAILED) {
+        mapping = nullptr;
+        mappingSize = 0;
+        throw PerfectHashDictionaryException{"could not map " + path + " into memory"};
+    }
+
+    const char* base = static_cast<const char*>(mapping);
+    Header header;
+    std::memcpy(&header, base, sizeof(Header));
+
+    std::uint64_t expectedSize = sizeof(Header)
+        + sizeof(std::uint32_t) * (std::uint64_t{header.bucketCount} + header.count + 1)
+        + header.blobSize;
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.bucketCount == 0 || expectedSize != mappingSize) {
+        unmap();
+        throw PerfectHashDictionaryException{path + " is not a dictionary file"};
+    }
+
+    seed = header.seed;
+    count = header.count;
+    bucketCount = header.bucketCount;
+    pilots = reinterpret_cast<const std::uint32_t*>(base + sizeof(Header));
+    offsets = pilots + bucketCount;
+    blob = reinterpret_cast<const char*>(offsets + count + 1);
+    blobSize = header.blobSize;
+}
+
+
+void PerfectHashDictionary::unmap() noexcept
+{
+    if(mapping != nullptr) {
+        ::munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    count = 0;
+}
+
@@ -0,0 +1,137 @@
+// PerfectHashDictionary.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A PerfectHashDictionary is a read-only Set of strings that lives in a
+// file built ahead of time by writePerfectHashDictionary() (and the
+// mphbuild tool that calls it).  Opening one doesn't copy or rebuild
+// anything: the file is mapped into memory with mmap() and used where it
+// lies, so startup takes constant time, only checking that the header
+// matches the size of the file, and every process that opens the same file
+// shares one copy of it through the operating system's page cache.  Each
+// lookup checks that the offsets it reads lie within the blob, so a
+// corrupt file makes words go missing rather than reading out of bounds.
+//
+// The file holds a minimal perfect hash function for its words -- one that
+// maps each of the n words to a different slot in 0..n-1 -- built with the
+// "hash and displace" technique.  Each word's 64-bit hash picks one of a
+// smaller number of buckets, and each bucket stores a "pilot" value that
+// was chosen, when the file was built, so that its words land in slots no
+// other word uses.  Looking a word up takes one hash of the word, one read
+// of a pilot, and one comparison against the only word that could be in
+// the slot it leads to.
+//
+// The file is laid out as follows, with every integer in the byte order of
+// the machine that built it:
+//
+//     Header       magic "MPHDICT1", the hash seed, the number of words n,
+//                  the number of buckets, and the size of the string blob
+//     pilots       one uint32_t per bucket
+//     offsets      n + 1 uint32_t's; the word in slot i occupies bytes
+//                  offsets[i] up to offsets[i + 1] of the blob
+//     blob         the words, packed together with no separators
+
+#ifndef PERFECTHASHDICTIONARY_HPP
+#define PERFECTHASHDICTIONARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Set.hpp"
+
+
+
+// A PerfectHashDictionaryException is thrown when a dictionary file can't
+// be written, opened, or understood, or when something tries to add a word
+// to a PerfectHashDictionary.
+
+class PerfectHashDictionaryException
+{
+public:
+    explicit PerfectHashDictionaryException(const std::string& reason);
+
+    const std::string& reason() const;
+
+private:
+    std::string reason_;
+};
+
+
+
+// writePerfectHashDictionary() builds a dictionary file containing the
+// given words (duplicates are ignored) and writes it to the given path.
+// The file is written under a temporary name in the same directory and
+// then renamed into place, so processes that already have a dictionary
+// open at that path keep using the old one safely.
+
+void writePerfectHashDictionary(const std::vector<std::string>& words, const std::string& path);
+
+
+
+class PerfectHashDictionary : public Set<std::string>
+{
+public:
+    // Maps the dictionary file at the given path into memory.
+    explicit PerfectHashDictionary(const std::string& path);
+
+    // Unmaps the file.
+    virtual ~PerfectHashDictionary() noexcept;
+
+    // Initializes a new PerfectHashDictionary by mapping the same file as
+    // an existing one.
+    PerfectHashDictionary(const PerfectHashDictionary& d);
+
+    // Initializes a new PerfectHashDictionary that takes over the mapping
+    // of an expiring one.
+    PerfectHashDictionary(PerfectHashDictionary&& d) noexcept;
+
+    PerfectHashDictionary& operator=(const PerfectHashDictionary& d);
+    PerfectHashDictionary& operator=(PerfectHashDictionary&& d) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() always throws a PerfectHashDictionaryException, since the
+    // dictionary is read-only.
+    virtual void add(const std::string& element) override;
+
+
+    // contains() returns true if the given word is in the dictionary,
+    // false otherwise.  It runs in constant time, making one hash and one
+    // string comparison.  If the offsets of the slot the word hashes to
+    // are out of order or past the end of the blob, it returns false.
+    virtual bool contains(const std::string& element) const override;
+
+
+    // containsKey() is contains() for a word that isn't (or isn't yet)
+    // a std::string.
+    bool containsKey(std::string_view word) const;
+
+
+    virtual unsigned int size() const noexcept override;
+
+
+private:
+    std::string path;
+    void* mapping;
+    std::size_t mappingSize;
+    std::uint64_t seed;
+    std::uint32_t count;
+    std::uint32_t bucketCount;
+    const std::uint32_t* pilots;
+    const std::uint32_t* offsets;
+    const char* blob;
+    std::uint64_t blobSize;
+
+    void map();
+    void unmap() noexcept;
+};
+
+
+
+#endif // PERFECTHASHDICTIONARY_HPP
+
@@ -0,0 +1,399 @@
+// PersistentAVLSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A PersistentAVLSet is an AVL tree whose nodes never change once they've
+// been built, so that any number of sets can share them.  Copying a
+// PersistentAVLSet (or taking a snapshot() of one) just shares its root,
+// which takes O(1) time no matter how large the set is.  Adding an element
+// builds new copies of only the O(log n) nodes on the path from the root to
+// where the element belongs (plus any that are rotated), sharing all of
+// the others with the previous version of the tree; this is sometimes
+// called "path copying."  Every earlier version of the set stays intact
+// and readable for as long as something holds onto it.
+//
+// Each node counts the number of references to it, from its parents and
+// from the sets whose root it is, and is deleted when that count drops to
+// zero.  The counts are atomic, so a snapshot can be handed to another
+// thread and read (and eventually destroyed) there while this set goes on
+// changing.  A single PersistentAVLSet object still mustn't be changed by
+// one thread while another uses it; it's the snapshots that can be shared.
+//
+// Since nodes can outlive the set that built them, and be freed by any
+// thread, they're allocated individually rather than from a NodePool.
+
+#ifndef PERSISTENTAVLSET_HPP
+#define PERSISTENTAVLSET_HPP
+
+#include <atomic>
+#include <utility>
+#include "AVLSet.hpp"
+#include "Set.hpp"
+
+
+
+template <typename ElementType>
+class PersistentAVLSet : public Set<ElementType>
+{
+public:
+    // Initializes a PersistentAVLSet to be empty.
+    PersistentAVLSet() noexcept;
+
+    // Lets go of this set's tree, freeing whatever nodes aren't shared
+    // with another version of it.
+    virtual ~PersistentAVLSet() noexcept;
+
+    // Initializes a new PersistentAVLSet to be a copy of an existing one,
+    // sharing its tree.  This takes O(1) time.
+    PersistentAVLSet(const PersistentAVLSet& s) noexcept;
+
+    // Initializes a new PersistentAVLSet whose contents are moved from an
+    // expiring one.
+    PersistentAVLSet(PersistentAVLSet&& s) noexcept;
+
+    PersistentAVLSet& operator=(const PersistentAVLSet& s) noexcept;
+    PersistentAVLSet& operator=(PersistentAVLSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set, copying the nodes on its path and
+    // leaving every other version of the set unchanged.  If the element is
+    // already in the set, this function has no effect and copies nothing.
+    // This function always runs in O(log n) time.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function always runs in O(log n) time.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // containsKey() is contains() for a key that can be of some type other
+    // than ElementType, as in AVLSet.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
+    virtual unsigned int size() const noexcept override;
+
+
+    // height() returns the height of the AVL tree, which is -1 when the
+    // tree is empty.
+    int height() const noexcept;
+
+
+    // snapshot() returns an unchanging copy of the set as it is now, which
+    // takes O(1) time.
+    PersistentAVLSet snapshot() const noexcept;
+
+
+    // inorder() calls the given "visit" function for each of the elements
+    // in the set, in ascending order.
+    template <typename Visitor>
+    void inorder(Visitor visit) const;
+
+
+private:
+    struct Node {
+        ElementType value;
+        const Node* left;
+        const Node* right;
+        int h;
+        mutable std::atomic<unsigned int> refs;
+
+        Node(const ElementType& value, const Node* left, const Node* right, int h)
+            : value{value}, left{left}, right{right}, h{h}, refs{1}
+        {
+        }
+    };
+
+    const Node* root;
+    unsigned int sz;
+
+    static const Node* acquire(const Node* n) noexcept;
+    static void release(const Node* n) noexcept;
+    static int heightOf(const Node* n) noexcept;
+    static const Node* makeNode(const ElementType& value, const Node* l, const Node* r);
+    static const Node* balance(const ElementType& value, const Node* l, const Node* r);
+    static const Node* insert(const Node* n, const ElementType& element, bool& added);
+};
+
+
+
+// References are handed around by a simple rule: a function that is given
+// a node pointer it's expected to keep (such as makeNode() and balance(),
+// for their l and r) takes over one reference to it, and a function that
+// returns a node pointer (other than acquire()) hands one reference over to
+// its caller.  A node that is only being read is borrowed, and its count
+// isn't touched.
+
+template <typename ElementType>
+const typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::acquire(
+    const Node* n) noexcept
+{
+    if(n != nullptr) {
+        n->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    return n;
+}
+
+
+// release() drops one reference to a node, deleting it (and dropping its
+// references to its children) if that was the last one.  It loops down
+// right children rather than recursing, so it recurses only as deeply as
+// the tree is tall.
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::release(const Node* n) noexcept
+{
+    while(n != nullptr && n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        release(n->left);
+        const Node* right = n->right;
+        delete n;
+        n = right;
+    }
+}
+
+
+template <typename ElementType>
+int PersistentAVLSet<ElementType>::heightOf(const Node* n) noexcept
+{
+    return n == nullptr ? -1 : n->h;
+}
+
+
+template <typename ElementType>
+const typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::makeNode(
+    const ElementType& value, const Node* l, const Node* r)
+{
+    int hl = heightOf(l);
+    int hr = heightOf(r);
+    try {
+        return new Node{value, l, r, (hl > hr ? hl : hr) + 1};
+    }
+    catch(...) {
+        release(l);
+        release(r);
+        throw;
+    }
+}
+
+
+// balance() builds a node with the given value and subtrees, rotating if
+// they differ in height by two.  Rotations can't rearrange the existing
+// nodes, which may be shared, so they build new ones instead and let go of
+// the child they replace.
+template <typename ElementType>
+const typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::balance(
+    const ElementType& value, const Node* l, const Node* r)
+{
+    if(heightOf(l) > heightOf(r) + 1) {
+        const Node* result;
+        if(heightOf(l->left) >= heightOf(l->right)) {
+            result = makeNode(
+                l->value, acquire(l->left), makeNode(value, acquire(l->right), r));
+        }
+        else {
+            const Node* lr = l->right;
+            result = makeNode(
+                lr->value,
+                makeNode(l->value, acquire(l->left), acquire(lr->left)),
+                makeNode(value, acquire(lr->right), r));
+        }
+        release(l);
+        return result;
+    }
+    else if(heightOf(r) > heightOf(l) + 1) {
+        const Node* result;
+        if(heightOf(r->right) >= heightOf(r->left)) {
+            result = makeNode(
+                r->value, makeNode(value, l, acquire(r->left)), acquire(r->right));
+        }
+        else {
+            const Node* rl = r->left;
+            result = makeNode(
+                rl->value,
+                makeNode(value, l, acquire(rl->left)),
+                makeNode(r->value, acquire(rl->right), acquire(r->right)));
+        }
+        release(r);
+        return result;
+    }
+    else {
+        return makeNode(value, l, r);
+    }
+}
+
+
+// insert() returns the root of a new version of the subtree n with the
+// element added to it, or nullptr (with added set to false) if the element
+// was already there, in which case nothing was built.
+template <typename ElementType>
+const typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::insert(
+    const Node* n, const ElementType& element, bool& added)
+{
+    if(n == nullptr) {
+        added = true;
+        return makeNode(element, nullptr, nullptr);
+    }
+
+    int c = impl_::avlCompare(element, n->value);
+    if(c == 0) {
+        added = false;
+        return nullptr;
+    }
+    else if(c < 0) {
+        const Node* l = insert(n->left, element, added);
+        if(!added) {
+            return nullptr;
+        }
+        return balance(n->value, l, acquire(n->right));
+    }
+    else {
+        const Node* r = insert(n->right, element, added);
+        if(!added) {
+            return nullptr;
+        }
+        return balance(n->value, acquire(n->left), r);
+    }
+}
+
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::PersistentAVLSet() noexcept
+    : root{nullptr}, sz{0}
+{
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::~PersistentAVLSet() noexcept
+{
+    release(root);
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::PersistentAVLSet(const PersistentAVLSet& s) noexcept
+    : root{acquire(s.root)}, sz{s.sz}
+{
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::PersistentAVLSet(PersistentAVLSet&& s) noexcept
+    : root{s.root}, sz{s.sz}
+{
+    s.root = nullptr;
+    s.sz = 0;
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>& PersistentAVLSet<ElementType>::operator=(const PersistentAVLSet& s) noexcept
+{
+    const Node* old = root;
+    root = acquire(s.root);
+    sz = s.sz;
+    release(old);
+    return *this;
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>& PersistentAVLSet<ElementType>::operator=(PersistentAVLSet&& s) noexcept
+{
+    if(this != &s) {
+        std::swap(root, s.root);
+        std::swap(sz, s.sz);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::add(const ElementType& element)
+{
+    bool added = false;
+    const Node* newRoot = insert(root, element, added);
+    if(added) {
+        release(root);
+        root = newRoot;
+        sz += 1;
+    }
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::contains(const ElementType& element) const
+{
+    return containsKey(element);
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool PersistentAVLSet<ElementType>::containsKey(const Key& key) const
+{
+    const Node* n = root;
+    while(n != nullptr) {
+        int c = impl_::avlCompare(key, n->value);
+        if(c == 0) {
+            return true;
+        }
+        n = c < 0 ? n->left : n->right;
+    }
+    return false;
+}
+
+
+template <typename ElementType>
+unsigned int PersistentAVLSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+int PersistentAVLSet<ElementType>::height() const noexcept
+{
+    return heightOf(root);
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType> PersistentAVLSet<ElementType>::snapshot() const noexcept
+{
+    return PersistentAVLSet{*this};
+}
+
+
+template <typename ElementType>
+template <typename Visitor>
+void PersistentAVLSet<ElementType>::inorder(Visitor visit) const
+{
+    impl_::AVLPathStack<const Node*> path;
+    const Node* n = root;
+    while(n != nullptr || !path.empty()) {
+        for(; n != nullptr; n = n->left) {
+            path.push(n);
+        }
+        n = path.pop();
+        visit(n->value);
+        n = n->right;
+    }
+}
+
+
+
+#endif // PERSISTENTAVLSET_HPP
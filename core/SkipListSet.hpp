@@ -4,7 +4,28 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // A SkipListSet is an implementation of a Set that is a skip list, implemented
-// as we discussed in lecture.  A skip list is a sequence of levels
+// as we discussed in lecture.  A skip list is a sequence of levels, each of
+// which is a sorted linked list.  Every element is on level 0; each element
+// on a level is also on the level above it with probability 1/2 (which is
+// decided by a "level tester" object), so each level has about half as many
+// elements as the one below it, and a search can skip quickly across the
+// upper levels before dropping down to finish on the lower ones.
+//
+// In this implementation, each level begins with a node whose element is
+// never looked at, which plays the role of -INF, and ends with a null
+// pointer, which plays the role of +INF.  The nodes come from a NodePool.
+//
+// contains() always searches from the top, and never changes the skip
+// list, so any number of threads can call it at once.  A caller searching
+// for keys in sorted or nearly sorted order can instead ask for a Finger,
+// which remembers, on each of the lower levels, the last node a search
+// passed through there, and pass it to containsFrom().  A search then
+// starts at the lowest level where the Finger is still a good place to
+// start from, so a search for a key near the last one takes time
+// proportional to the log of the distance between them, rather than the
+// log of the size of the whole list.  Each thread needs its own Finger.
+// add() keeps fingers of its own, on every level, so that adding elements
+// in sorted order is fast in the same way.
 //
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the keys and their
@@ -24,12 +45,66 @@
 #ifndef SKIPLISTSET_HPP
 #define SKIPLISTSET_HPP
 
+#include <cstdint>
 #include <memory>
 #include <random>
+#include <stdexcept>
+#include "NodePool.hpp"
 #include "Set.hpp"
 
 
 
+namespace impl_
+{
+    // skipListTrailingZeros() returns the number of 0 bits below the
+    // lowest 1 bit in n, which must not be 0.
+    inline unsigned int skipListTrailingZeros(unsigned int n) noexcept
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_ctz(n));
+#else
+        unsigned int count = 0;
+        for(; (n & 1) == 0; n >>= 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+
+    // skipListTrailingZeros64() is skipListTrailingZeros() for a
+    // 64-bit n, except that it returns 64 when n is 0.
+    inline unsigned int skipListTrailingZeros64(std::uint64_t n) noexcept
+    {
+        if(n == 0) {
+            return 64;
+        }
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_ctzll(n));
+#else
+        unsigned int count = 0;
+        for(; (n & 1) == 0; n >>= 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+
+    // skipListNextRandom() advances a splitmix64 generator's state
+    // and returns its next 64 random bits, all of which are of good
+    // quality (including the low ones, which the level testers count).
+    inline std::uint64_t skipListNextRandom(std::uint64_t& state) noexcept
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+
+
 
 // SkipListKind indicates a kind of key: a normal one, the special key
 // -INF, or the special key +INF.  It's necessary for us to implement
@@ -104,12 +179,14 @@ bool SkipListKey<ElementType>::operator<(const SkipListKey& other) const
 // The SkipListLevelTester class represents the ability to decide whether
 // a key placed on one level of the skip list should also occupy the next
 // level.  This is the "coin flip," so to speak.  Note that this is an
-// abstract base class with one implementation, RandomSkipListLevelTester,
-// just below it.  RandomSkipListLevelTester is what it sounds like: It
-// makes the decision at random (with a 50/50 chance of deciding whether
-// a key should occupy the next level).  However, by setting things up
-// this way, we have a way to control things more carefully in our
-// testing (as you can, as well).
+// abstract base class with two implementations, RandomSkipListLevelTester
+// and GeometricSkipListLevelTester, just below it.  RandomSkipListLevelTester
+// is what it sounds like: It makes the decision at random (with a 50/50
+// chance of deciding whether a key should occupy the next level).
+// GeometricSkipListLevelTester decides at random, too, but more quickly;
+// the skip lists use it unless they're given something else.  However, by
+// setting things up this way, we have a way to control things more
+// carefully in our testing (as you can, as well).
 //
 // DO NOT MAKE CHANGES TO THE SIGNATURES OF THE MEMBER FUNCTIONS OF
 // THE "level tester" CLASSES.  You can add new member functions or even
@@ -125,6 +202,20 @@ public:
 
     virtual bool shouldOccupyNextLevel(const ElementType& element) = 0;
     virtual std::unique_ptr<SkipListLevelTester<ElementType>> clone() = 0;
+
+    // levelsToOccupy() decides, all at once, how many levels (at least 1,
+    // and at most maxLevels) a new key should occupy.  This is what the
+    // skip lists call; by default, it flips the coins one at a time by
+    // calling shouldOccupyNextLevel(), but a level tester can override it
+    // to decide more quickly.
+    virtual unsigned int levelsToOccupy(const ElementType& element, unsigned int maxLevels)
+    {
+        unsigned int levels = 1;
+        while(levels < maxLevels && shouldOccupyNextLevel(element)) {
+            levels++;
+        }
+        return levels;
+    }
 };
 
 
@@ -168,6 +259,78 @@ std::unique_ptr<SkipListLevelTester<ElementType>> RandomSkipListLevelTester<Elem
 
 
 
+// A GeometricSkipListLevelTester places a key on each level above the
+// first with probability 1/oneIn, where oneIn is a power of 2 (usually 2,
+// as with RandomSkipListLevelTester, or 4, which makes for about half as
+// many levels and a third as many nodes above level 0, at the cost of a
+// few more steps along each level during a search).  Rather than flipping
+// a coin for each level, levelsToOccupy() draws one 64-bit random number
+// and counts its trailing 0 bits: the chance that the lowest k * b bits
+// are all 0, where oneIn is 2^b, is exactly (1/oneIn)^k, so counting them
+// in groups of b bits gives the whole height at once, with one call to a
+// fast generator.  Constructing one with a oneIn that isn't a power of 2
+// (or is less than 2) throws a std::invalid_argument.
+
+template <typename ElementType>
+class GeometricSkipListLevelTester : public SkipListLevelTester<ElementType>
+{
+public:
+    explicit GeometricSkipListLevelTester(unsigned int oneIn = 2);
+    virtual ~GeometricSkipListLevelTester() = default;
+
+    virtual bool shouldOccupyNextLevel(const ElementType& element) override;
+    virtual unsigned int levelsToOccupy(const ElementType& element, unsigned int maxLevels) override;
+    virtual std::unique_ptr<SkipListLevelTester<ElementType>> clone() override;
+
+private:
+    std::uint64_t state;
+    unsigned int bitsPerLevel;
+};
+
+
+template <typename ElementType>
+GeometricSkipListLevelTester<ElementType>::GeometricSkipListLevelTester(unsigned int oneIn)
+    : state{0}, bitsPerLevel{1}
+{
+    if(oneIn < 2 || (oneIn & (oneIn - 1)) != 0) {
+        throw std::invalid_argument{
+            "GeometricSkipListLevelTester: oneIn must be a power of 2 that's at least 2"};
+    }
+    bitsPerLevel = impl_::skipListTrailingZeros(oneIn);
+
+    std::random_device device;
+    state = std::uint64_t{device()} << 32 | device();
+}
+
+
+template <typename ElementType>
+bool GeometricSkipListLevelTester<ElementType>::shouldOccupyNextLevel(const ElementType&)
+{
+    std::uint64_t mask = (std::uint64_t{1} << bitsPerLevel) - 1;
+    return (impl_::skipListNextRandom(state) & mask) == 0;
+}
+
+
+template <typename ElementType>
+unsigned int GeometricSkipListLevelTester<ElementType>::levelsToOccupy(
+    const ElementType&, unsigned int maxLevels)
+{
+    std::uint64_t bits = impl_::skipListNextRandom(state);
+    unsigned int levels = impl_::skipListTrailingZeros64(bits) / bitsPerLevel + 1;
+    return levels < maxLevels ? levels : maxLevels;
+}
+
+
+template <typename ElementType>
+std::unique_ptr<SkipListLevelTester<ElementType>> GeometricSkipListLevelTester<ElementType>::clone()
+{
+    return std::unique_ptr<SkipListLevelTester<ElementType>>{
+        new GeometricSkipListLevelTester<ElementType>{1u << bitsPerLevel}};
+}
+
+
+
+
 template <typename ElementType>
 class SkipListSet : public Set<ElementType>
 {
@@ -195,6 +358,21 @@ public:
     SkipListSet& operator=(SkipListSet&& s) noexcept;
 
 
+    // buildFromSorted() returns a SkipListSet containing the elements in
+    // the range [first, last), which must be in ascending order with no
+    // duplicates.  Rather than flipping coins, it places the i-th element
+    // (counting from 1) on one level for each time 2 divides i, plus level
+    // 0, so every second element is on level 1, every fourth on level 2,
+    // and so on, which is the shape the coin flips are aiming for.  The
+    // list is built in one pass, in O(n) time, without comparing any
+    // elements or calling the level tester, which is kept for later adds.
+    template <typename InputIterator>
+    static SkipListSet buildFromSorted(
+        InputIterator first, InputIterator last,
+        std::unique_ptr<SkipListLevelTester<ElementType>> levelTester
+            = std::make_unique<GeometricSkipListLevelTester<ElementType>>());
+
+
     // isImplemented() should be modified to return true if you've
     // decided to implement a SkipListSet, false otherwise.
     virtual bool isImplemented() const noexcept override;
@@ -210,10 +388,37 @@ public:
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function runs in an expected time of O(log n)
     // (i.e., over the long run, we expect the average to be O(log n))
-    // with very high probability.
+    // with very high probability.  It changes nothing, so it's safe to
+    // call from more than one thread at a time.
     virtual bool contains(const ElementType& element) const override;
 
 
+    // containsKey() returns true if the set contains an element equivalent
+    // to the given key, which can be of some type other than ElementType
+    // (such as a std::string_view, when the elements are std::strings), so
+    // that looking it up doesn't require building an ElementType first.
+    // Keys and elements must be comparable with < in both directions.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
+    // A Finger remembers where the last search that used it ended.  It
+    // stays usable as elements are added to the set it came from, but not
+    // once that set has been destroyed, assigned to, or moved from.
+    class Finger;
+
+    // finger() returns a Finger for searching this set that hasn't been
+    // used yet, and containsFrom() is containsKey(), except that it starts
+    // from where the given Finger's last search ended, when that's a good
+    // place to start, and leaves the Finger where this search ends.  A
+    // search for a key d elements away from the last one takes expected
+    // O(log d) time.
+    Finger finger() const noexcept;
+
+    template <typename Key>
+    bool containsFrom(Finger& f, const Key& key) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept override;
 
@@ -238,21 +443,49 @@ public:
 
 
 private:
+    struct Node {
+        ElementType value;
+        Node* next;
+        Node* down;
+    };
+
+    // A Level records the -INF node that begins a level, the level's
+    // finger, and how many elements are on it.
+    struct Level {
+        Node* head;
+        Node* finger;
+        unsigned int count;
+    };
+
+    // Searches only look for a place to start on the levels below this one,
+    // so a Finger only remembers nodes on these levels.
+    static constexpr unsigned int FINGER_LEVELS = 8;
+
     std::unique_ptr<SkipListLevelTester<ElementType>> levelTester;
+    NodePool<Node> pool;
+    Level* levelInfo;
+    unsigned int levels;
+    unsigned int levelCapacity;
+    unsigned int sz;
+
+    void addLevel();
+    void destroyAll() noexcept;
+    template <typename Key>
+    void moveFingersTo(const Key& key);
 };
 
 
 
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet()
-    : SkipListSet{std::make_unique<RandomSkipListLevelTester<ElementType>>()}
+    : SkipListSet{std::make_unique<GeometricSkipListLevelTester<ElementType>>()}
 {
 }
 
 
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester)
-    : levelTester{std::move(levelTester)}
+    : levelTester{std::move(levelTester)}, levelInfo{nullptr}, levels{0}, levelCapacity{0}, sz{0}
 {
 }
 
@@ -260,24 +493,70 @@ SkipListSet<ElementType>::SkipListSet(std::unique_ptr<SkipListLevelTester<Elemen
 template <typename ElementType>
 SkipListSet<ElementType>::~SkipListSet() noexcept
 {
+    destroyAll();
 }
 
 
+// The copy is built level by level, from the bottom up.  Each node's down
+// pointer is found by walking the level below in step with its copy until
+// reaching the node it points to, so the whole copy takes O(n) time and
+// every element stays on exactly the levels it was on.
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet(const SkipListSet& s)
+    : levelTester{s.levelTester ? s.levelTester->clone() : nullptr},
+      levelInfo{nullptr}, levels{0}, levelCapacity{0}, sz{0}
 {
+    try {
+        for(unsigned int level = 0; level < s.levels; level++) {
+            addLevel();
+            Node* tail = levelInfo[level].head;
+            Node* below = level > 0 ? s.levelInfo[level - 1].head : nullptr;
+            Node* belowCopy = level > 0 ? levelInfo[level - 1].head : nullptr;
+            for(Node* n = s.levelInfo[level].head->next; n != nullptr; n = n->next) {
+                Node* down = nullptr;
+                if(level > 0) {
+                    while(below != n->down) {
+                        below = below->next;
+                        belowCopy = belowCopy->next;
+                    }
+                    down = belowCopy;
+                }
+                tail->next = pool.create(n->value, nullptr, down);
+                tail = tail->next;
+            }
+            levelInfo[level].count = s.levelInfo[level].count;
+        }
+        sz = s.sz;
+    }
+    catch(...) {
+        destroyAll();
+        throw;
+    }
 }
 
 
+// A moved-from SkipListSet has no levels and no level tester; it can be
+// destroyed or assigned to, and if elements are added to it, they're only
+// placed on level 0.
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet(SkipListSet&& s) noexcept
+    : levelTester{std::move(s.levelTester)}, pool{std::move(s.pool)},
+      levelInfo{s.levelInfo}, levels{s.levels}, levelCapacity{s.levelCapacity}, sz{s.sz}
 {
+    s.levelInfo = nullptr;
+    s.levels = 0;
+    s.levelCapacity = 0;
+    s.sz = 0;
 }
 
 
 template <typename ElementType>
 SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(const SkipListSet& s)
 {
+    if(this != &s) {
+        SkipListSet copy{s};
+        *this = std::move(copy);
+    }
     return *this;
 }
 
@@ -285,58 +564,351 @@ SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(const SkipListSet&
 template <typename ElementType>
 SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(SkipListSet&& s) noexcept
 {
+    if(this != &s) {
+        std::swap(levelTester, s.levelTester);
+        std::swap(pool, s.pool);
+        std::swap(levelInfo, s.levelInfo);
+        std::swap(levels, s.levels);
+        std::swap(levelCapacity, s.levelCapacity);
+        std::swap(sz, s.sz);
+    }
     return *this;
 }
 
 
+// Each level's finger serves as the tail of that level while the list is
+// built, which leaves every finger at the end of its level; that's where a
+// search for a key larger than every element would have left them.  The
+// first element tall enough to need a new level is always exactly one
+// level taller than any before it.
+template <typename ElementType>
+template <typename InputIterator>
+SkipListSet<ElementType> SkipListSet<ElementType>::buildFromSorted(
+    InputIterator first, InputIterator last,
+    std::unique_ptr<SkipListLevelTester<ElementType>> levelTester)
+{
+    SkipListSet s{std::move(levelTester)};
+    s.addLevel();
+
+    for(unsigned int i = 1; first != last; ++first, i++) {
+        unsigned int height = impl_::skipListTrailingZeros(i) + 1;
+        if(height > s.levels) {
+            s.addLevel();
+        }
+
+        Node* below = nullptr;
+        for(unsigned int level = 0; level < height; level++) {
+            Level& info = s.levelInfo[level];
+            Node* node = s.pool.create(*first, nullptr, below);
+            info.finger->next = node;
+            info.finger = node;
+            info.count += 1;
+            below = node;
+        }
+        s.sz += 1;
+    }
+
+    return s;
+}
+
+
 template <typename ElementType>
 bool SkipListSet<ElementType>::isImplemented() const noexcept
 {
-    return false;
+    return true;
 }
 
 
+// add() searches for the element, which leaves the finger on every level
+// at the node that the element would follow there.  If it's not already in
+// the set, the level tester decides how many levels it should be on, which
+// can be at most one more than there are now, and it's linked in after the
+// finger on each of them, from the bottom up.
 template <typename ElementType>
 void SkipListSet<ElementType>::add(const ElementType& element)
 {
+    if(levels == 0) {
+        addLevel();
+    }
+
+    moveFingersTo(element);
+    Node* following = levelInfo[0].finger->next;
+    if(following != nullptr && !(element < following->value)) {
+        return;
+    }
+
+    unsigned int height = levelTester != nullptr ? levelTester->levelsToOccupy(element, levels + 1) : 1;
+    if(height > levels) {
+        addLevel();
+    }
+
+    Node* below = nullptr;
+    for(unsigned int level = 0; level < height; level++) {
+        Node* finger = levelInfo[level].finger;
+        finger->next = pool.create(element, finger->next, below);
+        below = finger->next;
+        levelInfo[level].count += 1;
+    }
+    sz += 1;
 }
 
 
 template <typename ElementType>
 bool SkipListSet<ElementType>::contains(const ElementType& element) const
 {
-    return false;
+    return containsKey(element);
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool SkipListSet<ElementType>::containsKey(const Key& key) const
+{
+    if(levels == 0) {
+        return false;
+    }
+
+    Node* n = levelInfo[levels - 1].head;
+    while(true) {
+        while(n->next != nullptr && n->next->value < key) {
+            n = n->next;
+        }
+        if(n->down == nullptr) {
+            return n->next != nullptr && !(key < n->next->value);
+        }
+        n = n->down;
+    }
+}
+
+
+template <typename ElementType>
+typename SkipListSet<ElementType>::Finger SkipListSet<ElementType>::finger() const noexcept
+{
+    return Finger{this};
+}
+
+
+// containsFrom() checks the Finger's nodes on levels 0, 1, 3, and 7, as
+// moveFingersTo() does, and starts from the first of them that's before the
+// key and followed by something that isn't, searching down from there and
+// moving the Finger's nodes on the levels below it.  Both sides are checked,
+// since elements may have been added around a node since the Finger was
+// left there.  A Finger from some other set is treated as a new one.
+template <typename ElementType>
+template <typename Key>
+bool SkipListSet<ElementType>::containsFrom(Finger& f, const Key& key) const
+{
+    if(levels == 0) {
+        return false;
+    }
+
+    if(f.owner != this) {
+        f = Finger{this};
+    }
+
+    unsigned int level = 0;
+    const Node* n = nullptr;
+    while(level < f.levels) {
+        const Node* start = f.nodes[level];
+        bool isGoodStart = (start == levelInfo[level].head || start->value < key)
+            && (start->next == nullptr || !(start->next->value < key));
+        if(isGoodStart) {
+            n = start;
+            break;
+        }
+        level = level * 2 + 1;
+    }
+
+    if(n == nullptr) {
+        level = levels - 1;
+        n = levelInfo[level].head;
+        f.levels = levels < FINGER_LEVELS ? levels : FINGER_LEVELS;
+    }
+
+    while(true) {
+        while(n->next != nullptr && n->next->value < key) {
+            n = n->next;
+        }
+        if(level < FINGER_LEVELS) {
+            f.nodes[level] = n;
+        }
+        if(level == 0) {
+            break;
+        }
+        level--;
+        n = n->down;
+    }
+
+    return n->next != nullptr && !(key < n->next->value);
 }
 
 
 template <typename ElementType>
 unsigned int SkipListSet<ElementType>::size() const noexcept
 {
-    return 0;
+    return sz;
 }
 
 
 template <typename ElementType>
 unsigned int SkipListSet<ElementType>::levelCount() const noexcept
 {
-    return 0;
+    return levels == 0 ? 1 : levels;
 }
 
 
 template <typename ElementType>
 unsigned int SkipListSet<ElementType>::elementsOnLevel(unsigned int level) const noexcept
 {
-    return 0;
+    if(level >= levels) {
+        return 0;
+    }
+    return levelInfo[level].count;
 }
 
 
 template <typename ElementType>
 bool SkipListSet<ElementType>::isElementOnLevel(const ElementType& element, unsigned int level) const
 {
-    return false;
+    if(level >= levels) {
+        return false;
+    }
+
+    Node* n = levelInfo[levels - 1].head;
+    for(unsigned int current = levels - 1; ; current--) {
+        while(n->next != nullptr && n->next->value < element) {
+            n = n->next;
+        }
+        if(current == level) {
+            return n->next != nullptr && !(element < n->next->value);
+        }
+        n = n->down;
+    }
+}
+
+
+template <typename ElementType>
+void SkipListSet<ElementType>::addLevel()
+{
+    if(levels == levelCapacity) {
+        unsigned int newCapacity = levelCapacity == 0 ? 8 : levelCapacity * 2;
+        Level* newLevelInfo = new Level[newCapacity];
+        for(unsigned int level = 0; level < levels; level++) {
+            newLevelInfo[level] = levelInfo[level];
+        }
+        delete[] levelInfo;
+        levelInfo = newLevelInfo;
+        levelCapacity = newCapacity;
+    }
+
+    Node* below = levels == 0 ? nullptr : levelInfo[levels - 1].head;
+    Node* head = pool.create(ElementType{}, nullptr, below);
+    levelInfo[levels] = Level{head, head, 0};
+    levels += 1;
+}
+
+
+template <typename ElementType>
+void SkipListSet<ElementType>::destroyAll() noexcept
+{
+    if(!NodePool<Node>::isTriviallyDestructible) {
+        for(unsigned int level = 0; level < levels; level++) {
+            Node* n = levelInfo[level].head;
+            while(n != nullptr) {
+                Node* next = n->next;
+                n->~Node();
+                n = next;
+            }
+        }
+    }
+    pool.release();
+    delete[] levelInfo;
+    levelInfo = nullptr;
+    levels = 0;
+    levelCapacity = 0;
+    sz = 0;
 }
 
 
+// moveFingersTo() leaves the finger on every level at the last node there
+// whose element is less than the key (or at the -INF node, if there's no
+// such node).  Only add() moves the fingers, and it links new nodes in
+// after them, so between adds, the fingers all mark where the last key
+// added would be on each level, so if the bottom finger is before
+// the key, the search is moving forward and every finger is before it;
+// otherwise, it's moving backward, and every finger is followed by
+// something that isn't less than it.  Either way, a level's finger is a
+// good place to start only if it's also on the other side of the key, and
+// if that's true of one level, it's true of every level above it, too.
+// (An element on a higher level that the finger there was supposed to
+// stop before would have been on the lower level, too.)
+//
+// So the search checks the fingers on levels 0, 1, 3, and 7, and starts
+// from the first of them that's a good place to start, searching down from
+// there as usual and moving the fingers on the levels below it.  A key
+// that's further than that from the last one is searched for from the top
+// level's -INF node instead; climbing all the way up for scattered keys
+// measured noticeably slower than simply starting from the top.
+template <typename ElementType>
+template <typename Key>
+void SkipListSet<ElementType>::moveFingersTo(const Key& key)
+{
+    Node* bottom = levelInfo[0].finger;
+    bool forward = bottom == levelInfo[0].head || bottom->value < key;
+
+    unsigned int level = 0;
+    Node* n = nullptr;
+    while(level < levels && level < FINGER_LEVELS) {
+        Node* finger = levelInfo[level].finger;
+        bool isGoodStart = forward
+            ? finger->next == nullptr || !(finger->next->value < key)
+            : finger == levelInfo[level].head || finger->value < key;
+        if(isGoodStart) {
+            n = finger;
+            break;
+        }
+        level = level * 2 + 1;
+    }
 
-#endif // SKIPLISTSET_HPP
+    if(n == nullptr) {
+        level = levels - 1;
+        n = levelInfo[level].head;
+    }
 
+    while(true) {
+        while(n->next != nullptr && n->next->value < key) {
+            n = n->next;
+        }
+        levelInfo[level].finger = n;
+        if(level == 0) {
+            break;
+        }
+        level--;
+        n = n->down;
+    }
+}
+
+
+
+template <typename ElementType>
+class SkipListSet<ElementType>::Finger
+{
+public:
+    Finger() noexcept = default;
+
+private:
+    friend class SkipListSet;
+
+    explicit Finger(const SkipListSet* owner) noexcept
+        : owner{owner}
+    {
+    }
+
+    const SkipListSet* owner = nullptr;
+    const Node* nodes[FINGER_LEVELS] = {};
+    unsigned int levels = 0;
+};
+
+
+
+#endif // SKIPLISTSET_HPP
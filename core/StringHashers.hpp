@@ -0,0 +1,200 @@
+// StringHashers.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Fast hash functions for strings, meant to be passed as the Hasher of a
+// HashSet (e.g., HashSet<std::string, WyStringHash>).  Each of them is a
+// small class whose function call operator can be inlined, and each takes
+// a std::string_view, so that it can hash a std::string, a string literal,
+// or a piece of a larger string without building a std::string first.
+// They all produce 64-bit hashes.
+//
+// WyStringHash follows the design of wyhash: the string is read eight bytes
+// at a time, and pairs of words are mixed together by multiplying them into
+// a 128-bit product and folding its halves together.  It's a good default.
+//
+// Crc32StringHash uses the CRC32 instruction added in SSE 4.2 to run a
+// 32-bit CRC over the string, then widens it to 64 bits by multiplying it
+// with the length and a seed.  (A second CRC over the same bytes wouldn't
+// add anything, since every CRC of a string is an affine function of every
+// other.)  It's only available when compiling for a processor that has the
+// instruction.
+
+#ifndef STRINGHASHERS_HPP
+#define STRINGHASHERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+
+
+namespace impl_
+{
+    inline std::uint64_t stringHashRead8(const unsigned char* p)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+
+    inline std::uint64_t stringHashRead4(const unsigned char* p)
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+
+    // stringHashMum() replaces a and b with the low and high halves
+    // of their 128-bit product.
+    inline void stringHashMum(std::uint64_t& a, std::uint64_t& b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = a;
+        r *= b;
+        a = static_cast<std::uint64_t>(r);
+        b = static_cast<std::uint64_t>(r >> 64);
+#else
+        std::uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xFFFFFFFFu, lb = b & 0xFFFFFFFFu;
+        std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        std::uint64_t t = rl + (rm0 << 32);
+        std::uint64_t c = t < rl;
+        std::uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        a = lo;
+        b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+
+
+    inline std::uint64_t stringHashMix(std::uint64_t a, std::uint64_t b)
+    {
+        stringHashMum(a, b);
+        return a ^ b;
+    }
+}
+
+
+
+class WyStringHash
+{
+public:
+    explicit WyStringHash(std::uint64_t seed = 0) noexcept
+        : seed{seed}
+    {
+    }
+
+    std::uint64_t operator()(std::string_view s) const noexcept
+    {
+        using namespace impl_;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+        std::size_t len = s.size();
+        std::uint64_t h = seed ^ stringHashMix(seed ^ SECRET0, SECRET1);
+        std::uint64_t a;
+        std::uint64_t b;
+
+        if(len <= 16) {
+            if(len >= 4) {
+                std::size_t mid = (len >> 3) << 2;
+                a = (stringHashRead4(p) << 32) | stringHashRead4(p + mid);
+                b = (stringHashRead4(p + len - 4) << 32) | stringHashRead4(p + len - 4 - mid);
+            }
+            else if(len > 0) {
+                a = (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[len >> 1]} << 8) | p[len - 1];
+                b = 0;
+            }
+            else {
+                a = 0;
+                b = 0;
+            }
+        }
+        else {
+            std::size_t i = len;
+            if(i > 48) {
+                std::uint64_t h1 = h;
+                std::uint64_t h2 = h;
+                do {
+                    h = stringHashMix(stringHashRead8(p) ^ SECRET1, stringHashRead8(p + 8) ^ h);
+                    h1 = stringHashMix(stringHashRead8(p + 16) ^ SECRET2, stringHashRead8(p + 24) ^ h1);
+                    h2 = stringHashMix(stringHashRead8(p + 32) ^ SECRET3, stringHashRead8(p + 40) ^ h2);
+                    p += 48;
+                    i -= 48;
+                } while(i > 48);
+                h ^= h1 ^ h2;
+            }
+            while(i > 16) {
+                h = stringHashMix(stringHashRead8(p) ^ SECRET1, stringHashRead8(p + 8) ^ h);
+                p += 16;
+                i -= 16;
+            }
+            a = stringHashRead8(p + i - 16);
+            b = stringHashRead8(p + i - 8);
+        }
+
+        a ^= SECRET1;
+        b ^= h;
+        stringHashMum(a, b);
+        return stringHashMix(a ^ SECRET0 ^ len, b ^ SECRET1);
+    }
+
+private:
+    static constexpr std::uint64_t SECRET0 = 0x2d358dccaa6c78a5ull;
+    static constexpr std::uint64_t SECRET1 = 0x8bb84b93962eacc9ull;
+    static constexpr std::uint64_t SECRET2 = 0x4b33a62ed433d4a3ull;
+    static constexpr std::uint64_t SECRET3 = 0x4d5a2da51de1aa47ull;
+
+    std::uint64_t seed;
+};
+
+
+
+#if defined(__SSE4_2__)
+
+class Crc32StringHash
+{
+public:
+    explicit Crc32StringHash(std::uint64_t seed = 0) noexcept
+        : seed{seed}
+    {
+    }
+
+    std::uint64_t operator()(std::string_view s) const noexcept
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+        std::size_t len = s.size();
+        std::uint64_t crc = 0x9e3779b9u;
+
+        for(std::size_t i = len; i >= 8; i -= 8, p += 8) {
+            crc = _mm_crc32_u64(crc, impl_::stringHashRead8(p));
+        }
+        if((len & 4) != 0) {
+            crc = _mm_crc32_u32(static_cast<std::uint32_t>(crc),
+                static_cast<std::uint32_t>(impl_::stringHashRead4(p)));
+            p += 4;
+        }
+        for(std::size_t i = len & 3; i > 0; i--, p++) {
+            crc = _mm_crc32_u8(static_cast<std::uint32_t>(crc), *p);
+        }
+        return impl_::stringHashMix(crc ^ (std::uint64_t{len} << 32) ^ SECRET0, seed ^ SECRET1);
+    }
+
+private:
+    static constexpr std::uint64_t SECRET0 = 0x2d358dccaa6c78a5ull;
+    static constexpr std::uint64_t SECRET1 = 0x8bb84b93962eacc9ull;
+
+    std::uint64_t seed;
+};
+
+#endif
+
+
+
+#endif // STRINGHASHERS_HPP
+
@@ -0,0 +1,583 @@
+// UnrolledSkipListSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An UnrolledSkipListSet is an implementation of a Set that is a skip list
+// whose nodes each hold a small sorted block of elements, rather than just
+// one.  (This is sometimes called a "B-skiplist.")  Every level is a linked
+// list of blocks.  Level 0 holds every element; each element on a level is
+// also on the level above it with probability 1/FANOUT, and, on every level
+// above 0, each element carries a pointer down to the block on the level
+// below that begins with it.
+//
+// A search binary-searches one block on each level for the last element
+// not greater than the key, follows that element's pointer down, and, on
+// the level below, may step right past a block or two that were split off
+// when their neighbors filled up.  Since a block holds about FANOUT
+// elements, each level narrows the search by about that much, so a search
+// follows about log n / log FANOUT pointers instead of the 2 log n or so
+// that a SkipListSet does, and the elements it compares against sit next
+// to each other in memory.  Storing elements in blocks also spreads the
+// cost of the pointers over many elements.
+//
+// When an element is added on more than one level, the block it lands in
+// on each level below its highest is split just before it, so that it
+// begins a block that the level above can point to.  When a block is full,
+// it's split in half.  Blocks are never merged.
+//
+// The first block on each level also plays the role of -INF: a search that
+// finds nothing in it that isn't greater than the key continues from the
+// first block of the level below.
+
+#ifndef UNROLLEDSKIPLISTSET_HPP
+#define UNROLLEDSKIPLISTSET_HPP
+
+#include <utility>
+#include "NodePool.hpp"
+#include "Set.hpp"
+#include "SkipListSet.hpp"
+
+
+
+namespace impl_
+{
+    // unrolledSkipListDefaultCapacity() returns the number of elements
+    // of a type that fit in about 1024 bytes (sixteen cache lines), but never
+    // fewer than 4.  A block is binary-searched, so it touches only a few of
+    // those cache lines; blocks this large measured well ahead of smaller
+    // ones for std::string elements, since they make for fewer levels.
+    template <typename ElementType>
+    constexpr unsigned int unrolledSkipListDefaultCapacity()
+    {
+        return sizeof(ElementType) * 4 >= 1024 ? 4 : static_cast<unsigned int>(1024 / sizeof(ElementType));
+    }
+
+
+    // unrolledSkipListFanout() returns the largest power of 2 that
+    // isn't more than half of the given block capacity.
+    constexpr unsigned int unrolledSkipListFanout(unsigned int blockCapacity)
+    {
+        unsigned int fanout = 1;
+        while(fanout * 4 <= blockCapacity) {
+            fanout *= 2;
+        }
+        return fanout;
+    }
+}
+
+
+
+template <
+    typename ElementType,
+    unsigned int BlockCapacity = impl_::unrolledSkipListDefaultCapacity<ElementType>()>
+class UnrolledSkipListSet : public Set<ElementType>
+{
+public:
+    static_assert(BlockCapacity >= 4, "a block must be able to hold at least four elements");
+
+    // The number of elements a block can hold.
+    static constexpr unsigned int BLOCK_CAPACITY = BlockCapacity;
+
+    // An element on one level is also on the next with probability
+    // 1 / FANOUT, which is a power of 2 no more than half of the block
+    // capacity, so that a GeometricSkipListLevelTester can decide how many
+    // levels an element is on with a single random number.
+    static constexpr unsigned int FANOUT = impl_::unrolledSkipListFanout(BlockCapacity);
+
+    // The most levels an UnrolledSkipListSet can have.
+    static constexpr unsigned int MAX_LEVELS = 32;
+
+public:
+    // Initializes an UnrolledSkipListSet to be empty.
+    UnrolledSkipListSet();
+
+    // Cleans up the UnrolledSkipListSet so that it leaks no memory.
+    virtual ~UnrolledSkipListSet() noexcept;
+
+    // Initializes a new UnrolledSkipListSet to be a copy of an existing one,
+    // with the same blocks holding the same elements.
+    UnrolledSkipListSet(const UnrolledSkipListSet& s);
+
+    // Initializes a new UnrolledSkipListSet whose contents are moved from
+    // an expiring one.
+    UnrolledSkipListSet(UnrolledSkipListSet&& s) noexcept;
+
+    // Assigns an existing UnrolledSkipListSet into another.
+    UnrolledSkipListSet& operator=(const UnrolledSkipListSet& s);
+
+    // Assigns an expiring UnrolledSkipListSet into another.
+    UnrolledSkipListSet& operator=(UnrolledSkipListSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in an expected
+    // time of O(log n), plus the time to shift the elements of the blocks
+    // it changes over by one.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in an expected time of
+    // O(log n).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // containsKey() is contains() for a key that can be of some type other
+    // than ElementType.  Keys and elements must be comparable with < in
+    // both directions.
+    template <typename Key>
+    bool containsKey(const Key& key) const;
+
+
+    virtual unsigned int size() const noexcept override;
+
+
+    // levelCount(), elementsOnLevel(), and isElementOnLevel() report on
+    // the levels the way SkipListSet's versions do.  blocksOnLevel()
+    // returns the number of blocks in the given level (including its
+    // first block, even if it's empty), or 0 if the level doesn't exist.
+    unsigned int levelCount() const noexcept;
+    unsigned int elementsOnLevel(unsigned int level) const noexcept;
+    bool isElementOnLevel(const ElementType& element, unsigned int level) const;
+    unsigned int blocksOnLevel(unsigned int level) const noexcept;
+
+
+private:
+    struct Block {
+        Block* next;
+        unsigned int count;
+        ElementType keys[BlockCapacity];
+    };
+
+    // A Block on a level above 0 also has, for each of its elements, the
+    // block on the level below that begins with that element.
+    struct IndexBlock : Block {
+        Block* downs[BlockCapacity];
+    };
+
+    struct Level {
+        Block* head;
+        unsigned int count;
+        unsigned int blocks;
+    };
+
+    NodePool<Block> leaves;
+    NodePool<IndexBlock> indexes;
+    Level levelInfo[MAX_LEVELS];
+    unsigned int levels;
+    unsigned int sz;
+    GeometricSkipListLevelTester<ElementType> levelTester;
+
+    static IndexBlock* asIndex(Block* b) noexcept;
+    template <typename Key>
+    static unsigned int upperBound(const Block* b, const Key& key);
+    template <typename Key>
+    static Block* advance(Block* b, const Key& key);
+
+    Block* makeBlock(unsigned int level);
+    void addLevel();
+    void destroyAll() noexcept;
+    void moveTail(Block* from, unsigned int first, Block* to, unsigned int level) noexcept;
+    void insertAt(Block* b, unsigned int position, const ElementType& element, Block* down, unsigned int level);
+    template <typename Key>
+    Block* findBlock(const Key& key, unsigned int level) const;
+};
+
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+typename UnrolledSkipListSet<ElementType, BlockCapacity>::IndexBlock*
+UnrolledSkipListSet<ElementType, BlockCapacity>::asIndex(Block* b) noexcept
+{
+    return static_cast<IndexBlock*>(b);
+}
+
+
+// upperBound() returns the index of the first element in the block that is
+// greater than the key, or the block's count if there isn't one.
+template <typename ElementType, unsigned int BlockCapacity>
+template <typename Key>
+unsigned int UnrolledSkipListSet<ElementType, BlockCapacity>::upperBound(const Block* b, const Key& key)
+{
+    unsigned int low = 0;
+    unsigned int remaining = b->count;
+    while(remaining > 0) {
+        unsigned int half = remaining / 2;
+        if(key < b->keys[low + half]) {
+            remaining = half;
+        }
+        else {
+            low += half + 1;
+            remaining -= half + 1;
+        }
+    }
+    return low;
+}
+
+
+// advance() steps right from a block past any blocks whose first element
+// isn't greater than the key.
+template <typename ElementType, unsigned int BlockCapacity>
+template <typename Key>
+typename UnrolledSkipListSet<ElementType, BlockCapacity>::Block*
+UnrolledSkipListSet<ElementType, BlockCapacity>::advance(Block* b, const Key& key)
+{
+    while(b->next != nullptr && !(key < b->next->keys[0])) {
+        b = b->next;
+    }
+    return b;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+typename UnrolledSkipListSet<ElementType, BlockCapacity>::Block*
+UnrolledSkipListSet<ElementType, BlockCapacity>::makeBlock(unsigned int level)
+{
+    Block* b = level == 0 ? leaves.create() : indexes.create();
+    levelInfo[level].blocks += 1;
+    return b;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+void UnrolledSkipListSet<ElementType, BlockCapacity>::addLevel()
+{
+    levelInfo[levels] = Level{nullptr, 0, 0};
+    levelInfo[levels].head = makeBlock(levels);
+    levels += 1;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+void UnrolledSkipListSet<ElementType, BlockCapacity>::destroyAll() noexcept
+{
+    for(unsigned int level = 0; level < levels; level++) {
+        Block* b = levelInfo[level].head;
+        while(b != nullptr) {
+            Block* next = b->next;
+            if(level == 0) {
+                leaves.destroy(b);
+            }
+            else {
+                indexes.destroy(asIndex(b));
+            }
+            b = next;
+        }
+    }
+    leaves.release();
+    indexes.release();
+    levels = 0;
+    sz = 0;
+}
+
+
+// moveTail() moves the elements of a block from the given index onward
+// (along with their down pointers, above level 0) to the end of another.
+template <typename ElementType, unsigned int BlockCapacity>
+void UnrolledSkipListSet<ElementType, BlockCapacity>::moveTail(
+    Block* from, unsigned int first, Block* to, unsigned int level) noexcept
+{
+    for(unsigned int i = first; i < from->count; i++) {
+        to->keys[to->count] = std::move(from->keys[i]);
+        if(level > 0) {
+            asIndex(to)->downs[to->count] = asIndex(from)->downs[i];
+        }
+        to->count += 1;
+    }
+    from->count = first;
+}
+
+
+// insertAt() inserts an element into a block at the given index, splitting
+// the block in half first if it's full.
+template <typename ElementType, unsigned int BlockCapacity>
+void UnrolledSkipListSet<ElementType, BlockCapacity>::insertAt(
+    Block* b, unsigned int position, const ElementType& element, Block* down, unsigned int level)
+{
+    if(b->count == BlockCapacity) {
+        Block* half = makeBlock(level);
+        moveTail(b, BlockCapacity / 2, half, level);
+        half->next = b->next;
+        b->next = half;
+        if(position > BlockCapacity / 2) {
+            b = half;
+            position -= BlockCapacity / 2;
+        }
+    }
+
+    for(unsigned int i = b->count; i > position; i--) {
+        b->keys[i] = std::move(b->keys[i - 1]);
+        if(level > 0) {
+            asIndex(b)->downs[i] = asIndex(b)->downs[i - 1];
+        }
+    }
+    b->keys[position] = element;
+    if(level > 0) {
+        asIndex(b)->downs[position] = down;
+    }
+    b->count += 1;
+}
+
+
+// findBlock() returns the block on the given level that the key is in, or
+// would be placed in.
+template <typename ElementType, unsigned int BlockCapacity>
+template <typename Key>
+typename UnrolledSkipListSet<ElementType, BlockCapacity>::Block*
+UnrolledSkipListSet<ElementType, BlockCapacity>::findBlock(const Key& key, unsigned int level) const
+{
+    Block* b = levelInfo[levels - 1].head;
+    for(unsigned int current = levels - 1; current > level; current--) {
+        b = advance(b, key);
+        unsigned int i = upperBound(b, key);
+        b = i == 0 ? levelInfo[current - 1].head : asIndex(b)->downs[i - 1];
+    }
+    return advance(b, key);
+}
+
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+UnrolledSkipListSet<ElementType, BlockCapacity>::UnrolledSkipListSet()
+    : levels{0}, sz{0}, levelTester{FANOUT}
+{
+    addLevel();
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+UnrolledSkipListSet<ElementType, BlockCapacity>::~UnrolledSkipListSet() noexcept
+{
+    destroyAll();
+}
+
+
+// The copy is built level by level, from the bottom up.  A level's down
+// pointers refer to the blocks below in order, so each is found by walking
+// the level below in step with its copy, and the whole copy takes time
+// proportional to the number of blocks plus the number of elements.
+template <typename ElementType, unsigned int BlockCapacity>
+UnrolledSkipListSet<ElementType, BlockCapacity>::UnrolledSkipListSet(const UnrolledSkipListSet& s)
+    : UnrolledSkipListSet{}
+{
+    for(unsigned int level = 0; level < s.levels; level++) {
+        if(level > 0) {
+            addLevel();
+        }
+
+        Block* below = level > 0 ? s.levelInfo[level - 1].head : nullptr;
+        Block* belowCopy = level > 0 ? levelInfo[level - 1].head : nullptr;
+        Block* copy = levelInfo[level].head;
+        for(Block* b = s.levelInfo[level].head; b != nullptr; b = b->next) {
+            if(b != s.levelInfo[level].head) {
+                copy->next = makeBlock(level);
+                copy = copy->next;
+            }
+            for(unsigned int i = 0; i < b->count; i++) {
+                copy->keys[i] = b->keys[i];
+                if(level > 0) {
+                    while(below != asIndex(b)->downs[i]) {
+                        below = below->next;
+                        belowCopy = belowCopy->next;
+                    }
+                    asIndex(copy)->downs[i] = belowCopy;
+                }
+                copy->count = i + 1;
+            }
+        }
+        levelInfo[level].count = s.levelInfo[level].count;
+    }
+    sz = s.sz;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+UnrolledSkipListSet<ElementType, BlockCapacity>::UnrolledSkipListSet(UnrolledSkipListSet&& s) noexcept
+    : leaves{std::move(s.leaves)}, indexes{std::move(s.indexes)},
+      levels{s.levels}, sz{s.sz}, levelTester{s.levelTester}
+{
+    for(unsigned int level = 0; level < levels; level++) {
+        levelInfo[level] = s.levelInfo[level];
+    }
+    s.levels = 0;
+    s.sz = 0;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+UnrolledSkipListSet<ElementType, BlockCapacity>& UnrolledSkipListSet<ElementType, BlockCapacity>::operator=(
+    const UnrolledSkipListSet& s)
+{
+    if(this != &s) {
+        UnrolledSkipListSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+UnrolledSkipListSet<ElementType, BlockCapacity>& UnrolledSkipListSet<ElementType, BlockCapacity>::operator=(
+    UnrolledSkipListSet&& s) noexcept
+{
+    if(this != &s) {
+        std::swap(leaves, s.leaves);
+        std::swap(indexes, s.indexes);
+        std::swap(levelInfo, s.levelInfo);
+        std::swap(levels, s.levels);
+        std::swap(sz, s.sz);
+        std::swap(levelTester, s.levelTester);
+    }
+    return *this;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+bool UnrolledSkipListSet<ElementType, BlockCapacity>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+// add() first finds the block the element belongs in on every level.  On
+// the element's highest level, it's simply inserted into its block; on
+// each level below that, its block is split just before where it belongs,
+// and it's placed at the beginning of the new block, which the element on
+// the level above then points down to.  (The new block also gets the
+// elements that followed it, unless that's a full block's worth, which
+// happens only when it's before everything in a level's full first block;
+// in that case, those elements get a block of their own.)  Working from
+// the bottom up means that each block pointed down to exists by the time
+// the level above it is reached.
+//
+// A moved-from UnrolledSkipListSet has no levels, so it gets its first
+// one back here.
+template <typename ElementType, unsigned int BlockCapacity>
+void UnrolledSkipListSet<ElementType, BlockCapacity>::add(const ElementType& element)
+{
+    if(levels == 0) {
+        addLevel();
+    }
+
+    Block* path[MAX_LEVELS];
+    Block* b = levelInfo[levels - 1].head;
+    for(unsigned int level = levels - 1; ; level--) {
+        b = advance(b, element);
+        path[level] = b;
+        unsigned int i = upperBound(b, element);
+        if(level == 0) {
+            if(i > 0 && !(b->keys[i - 1] < element)) {
+                return;
+            }
+            break;
+        }
+        b = i == 0 ? levelInfo[level - 1].head : asIndex(b)->downs[i - 1];
+    }
+
+    unsigned int height = levelTester.levelsToOccupy(element, levels < MAX_LEVELS ? levels + 1 : MAX_LEVELS);
+    if(height > levels) {
+        addLevel();
+        path[levels - 1] = levelInfo[levels - 1].head;
+    }
+
+    Block* below = nullptr;
+    for(unsigned int level = 0; level < height; level++) {
+        b = path[level];
+        unsigned int position = upperBound(b, element);
+
+        if(level == height - 1) {
+            insertAt(b, position, element, below, level);
+        }
+        else {
+            Block* start = makeBlock(level);
+            start->next = b->next;
+            b->next = start;
+            if(b->count - position < BlockCapacity) {
+                insertAt(start, 0, element, below, level);
+                moveTail(b, position, start, level);
+            }
+            else {
+                Block* rest = makeBlock(level);
+                rest->next = start->next;
+                start->next = rest;
+                moveTail(b, position, rest, level);
+                insertAt(start, 0, element, below, level);
+            }
+            below = start;
+        }
+
+        levelInfo[level].count += 1;
+    }
+    sz += 1;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+bool UnrolledSkipListSet<ElementType, BlockCapacity>::contains(const ElementType& element) const
+{
+    return containsKey(element);
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+template <typename Key>
+bool UnrolledSkipListSet<ElementType, BlockCapacity>::containsKey(const Key& key) const
+{
+    if(levels == 0) {
+        return false;
+    }
+
+    Block* b = findBlock(key, 0);
+    unsigned int i = upperBound(b, key);
+    return i > 0 && !(b->keys[i - 1] < key);
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+unsigned int UnrolledSkipListSet<ElementType, BlockCapacity>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+unsigned int UnrolledSkipListSet<ElementType, BlockCapacity>::levelCount() const noexcept
+{
+    return levels == 0 ? 1 : levels;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+unsigned int UnrolledSkipListSet<ElementType, BlockCapacity>::elementsOnLevel(unsigned int level) const noexcept
+{
+    return level < levels ? levelInfo[level].count : 0;
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+bool UnrolledSkipListSet<ElementType, BlockCapacity>::isElementOnLevel(
+    const ElementType& element, unsigned int level) const
+{
+    if(level >= levels) {
+        return false;
+    }
+
+    Block* b = findBlock(element, level);
+    unsigned int i = upperBound(b, element);
+    return i > 0 && !(b->keys[i - 1] < element);
+}
+
+
+template <typename ElementType, unsigned int BlockCapacity>
+unsigned int UnrolledSkipListSet<ElementType, BlockCapacity>::blocksOnLevel(unsigned int level) const noexcept
+{
+    return level < levels ? levelInfo[level].blocks : 0;
+}
+
+
+
+#endif // UNROLLEDSKIPLISTSET_HPP
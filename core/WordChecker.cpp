@@ -11,11 +11,17 @@
 // The constructor requires a Set of words to be passed into it.  The
 // WordChecker will store a reference to a const Set, which it will use
 // whenever it needs to look up a word.
-WordChecker::WordChecker(const Set<std::string>& words): words{words} {}
+WordChecker::WordChecker(const Set<std::string>& words): words{words}, prefilter{nullptr} {}
+
+WordChecker::WordChecker(const Set<std::string>& words, const BlockedBloomFilter& prefilter)
+	: words{words}, prefilter{&prefilter} {}
 
 // wordExists() returns true if the given word is spelled correctly,
 // false otherwise.
 bool WordChecker::wordExists(const std::string& word) const {
+	if(prefilter != nullptr && !prefilter->mayContain(word)) {
+		return false;
+	}
 	return words.contains(word);
 }
 
@@ -24,7 +30,7 @@ std::string WordChecker::drop_const(const std::string& word) const{
 	return w;
 }
 
-bool WordChecker::contain_helper(std::vector<std::string> suggestions, std::string word) const {
+bool WordChecker::contain_helper(const std::vector<std::string>& suggestions, const std::string& word) const {
 	for(int i=0; i < suggestions.size(); i++) {
 		if(word == suggestions[i]) {
 			return true;
@@ -33,14 +39,19 @@ bool WordChecker::contain_helper(std::vector<std::string> suggestions, std::stri
 	return false;
 }
 
+// The candidate edits below are all made in place in one scratch string,
+// which is undone (or overwritten) before the next candidate, so that
+// probing the set doesn't allocate a new string for every candidate.
+
 std::vector<std::string> WordChecker::swapping_algorithm(std::vector<std::string> suggestions, const std::string& word) const {
 	int size = word.length();
+	std::string w = drop_const(word);
 	for(int i=0; i < size-1; i++) {
-		std::string w = drop_const(word);
 		std::swap(w[i], w[i+1]);
 		if(WordChecker::wordExists(w) && contain_helper(suggestions, w) == false) {
 			suggestions.push_back(w);
 		}
+		std::swap(w[i], w[i+1]);
 	}
 	return suggestions;
 }
@@ -48,10 +59,13 @@ std::vector<std::string> WordChecker::swapping_algorithm(std::vector<std::string
 std::vector<std::string> WordChecker::insertion_algorithm(std::vector<std::string> suggestions, const std::string& word) const {
 	std::string abc = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
 	int size = word.length();
+	std::string w;
+	w.reserve(size + 1);
 	for(int i=0; i <= size; i++) {
+		w.assign(word);
+		w.insert(w.begin()+i, abc[0]);
 		for(int j=0; j < abc.length(); j++) {
-			std::string w = drop_const(word);
-			w.insert(w.begin()+i, abc[j]);
+			w[i] = abc[j];
 			if(WordChecker::wordExists(w) && contain_helper(suggestions, w) == false) {
 				suggestions.push_back(w);
 			}
@@ -62,8 +76,10 @@ std::vector<std::string> WordChecker::insertion_algorithm(std::vector<std::strin
 
 std::vector<std::string> WordChecker::deletion_algorithm(std::vector<std::string> suggestions, const std::string& word) const {
 	int size = word.length();
+	std::string w;
+	w.reserve(size);
 	for(int i=0; i < size; i++) {
-		std::string w = drop_const(word);
+		w.assign(word);
 		w.erase(w.begin()+i);
 		if(WordChecker::wordExists(w) && contain_helper(suggestions, w) == false) {
 			suggestions.push_back(w);
@@ -75,25 +91,28 @@ std::vector<std::string> WordChecker::deletion_algorithm(std::vector<std::string
 std::vector<std::string> WordChecker::replace_algorithm(std::vector<std::string> suggestions, const std::string& word) const {
 	std::string abc = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
 	int size = word.length();
+	std::string w = drop_const(word);
 	for(int i=0; i < size; i++) {
 		for(int j=0; j < abc.length(); j++) {
-			std::string w = drop_const(word);
-			w.erase(w.begin()+i);
-			w.insert(w.begin()+i, abc[j]);
+			w[i] = abc[j];
 			if(WordChecker::wordExists(w) && contain_helper(suggestions, w) == false) {
 				suggestions.push_back(w);
 			}
 		}
+		w[i] = word[i];
 	}
 	return suggestions;
 }
 
 std::vector<std::string> WordChecker::splitting_algorithm(std::vector<std::string> suggestions, const std::string& word) const {
 	int size = word.length();
+	std::string w1;
+	std::string w2;
+	w1.reserve(size);
+	w2.reserve(size);
 	for(int i=1; i < size; i++) {
-		std::string w = drop_const(word);
-		std::string w1 = w.substr(0,i);
-		std::string w2 = w.substr(i,size);
+		w1.assign(word, 0, i);
+		w2.assign(word, i, size);
 		if(WordChecker::wordExists(w1) && WordChecker::wordExists(w2)) { //} && contain_helper(suggestions, w1) == false && ) {
 			if(contain_helper(suggestions, w1) == false) {
 				suggestions.push_back(w1);
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <vector>
+#include "BlockedBloomFilter.hpp"
 #include "Set.hpp"
 
 
@@ -30,6 +31,13 @@ public:
     // whenever it needs to look up a word.
     WordChecker(const Set<std::string>& words);
 
+    // This constructor also takes a filter built from the same words.  It's
+    // consulted before the Set, so that most words that aren't in the Set
+    // (as most of the candidates generated for suggestions aren't) are
+    // rejected without a full lookup.  The WordChecker stores a reference
+    // to the filter, too.
+    WordChecker(const Set<std::string>& words, const BlockedBloomFilter& prefilter);
+
 
     // wordExists() returns true if the given word is spelled correctly,
     // false otherwise.
@@ -44,13 +52,14 @@ public:
 
 private:
     const Set<std::string>& words;
+    const BlockedBloomFilter* prefilter;
     std::vector<std::string> swapping_algorithm(std::vector<std::string> suggestions, const std::string& word) const;
     std::vector<std::string> insertion_algorithm(std::vector<std::string> suggestions, const std::string& word) const;
     std::vector<std::string> deletion_algorithm(std::vector<std::string> suggestions, const std::string& word) const;
     std::vector<std::string> replace_algorithm(std::vector<std::string> suggestions, const std::string& word) const;
     std::vector<std::string> splitting_algorithm(std::vector<std::string> suggestions, const std::string& word) const;
     std::string drop_const(const std::string& word) const;
-    bool contain_helper(std::vector<std::string> suggestions, std::string word) const;
+    bool contain_helper(const std::vector<std::string>& suggestions, const std::string& word) const;
 };
 
 
@@ -6,11 +6,350 @@
 // Do whatever you'd like here.  This is intended to allow you to experiment
 // with your code, outside of the context of the broader program or Google
 // Test.
+//
+// At the moment, it's home to a few benchmarks: of the concurrent sets,
+// which print how throughput scales as threads are added, and of lookups
+// in the ordered sets.
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AVLSet.hpp"
+#include "ConcurrentHashSet.hpp"
+#include "ConcurrentSkipListSet.hpp"
+#include "FrozenOrderedSet.hpp"
+#include "SkipListSet.hpp"
+#include "UnrolledSkipListSet.hpp"
 
-int main()
+
+namespace
 {
+    unsigned int stringHash(const std::string& s)
+    {
+        unsigned int h = 2166136261u;
+        for(char c : s) {
+            h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return h;
+    }
+
+
+    std::vector<std::string> makeWords(unsigned int count, const std::string& prefix)
+    {
+        std::vector<std::string> words;
+        words.reserve(count);
+        for(unsigned int i=0; i < count; i++) {
+            words.push_back(prefix + std::to_string(i * 2654435761u));
+        }
+        return words;
+    }
+
+
+    // runThreads() starts the given number of threads, each running
+    // work(threadIndex), and returns how long it took for all of them
+    // to finish, in seconds.
+    template <typename Work>
+    double runThreads(unsigned int threadCount, Work work)
+    {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for(unsigned int t=0; t < threadCount; t++) {
+            threads.emplace_back(work, t);
+        }
+        for(std::thread& thread : threads) {
+            thread.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+
+    // Each thread performs a fixed number of operations against one shared
+    // dictionary, made by makeSet(): mostly lookups (half of them misses),
+    // with the given number of adds in every hundred operations.  Threads
+    // start at different places but cover the same words, so adds contend.
+    template <typename MakeSet>
+    void benchmarkConcurrentSet(const std::string& name, unsigned int addsPerHundred, MakeSet makeSet)
+    {
+        constexpr unsigned int dictionarySize = 200000;
+        constexpr unsigned int operationsPerThread = 1000000;
+
+        std::vector<std::string> present = makeWords(dictionarySize, "w");
+        std::vector<std::string> absent = makeWords(dictionarySize, "x");
+        unsigned int maxThreads = std::thread::hardware_concurrency();
+        if(maxThreads == 0) {
+            maxThreads = 4;
+        }
+
+        std::cout << name << ": " << dictionarySize << " words, "
+                  << operationsPerThread << " operations per thread, "
+                  << addsPerHundred << "% adds" << std::endl;
+
+        for(unsigned int threadCount=1; threadCount <= maxThreads; threadCount *= 2) {
+            auto set = makeSet();
+            for(unsigned int i=0; i < dictionarySize / 2; i++) {
+                set.add(present[i]);
+            }
+
+            std::vector<unsigned int> found(threadCount);
+            double seconds = runThreads(threadCount, [&](unsigned int t) {
+                unsigned int hits = 0;
+                unsigned int i = t * 7919;
+                for(unsigned int op=0; op < operationsPerThread; op++, i += 31) {
+                    const std::string& word = (op & 1) ? absent[i % dictionarySize] : present[i % dictionarySize];
+                    if(op % 100 < addsPerHundred) {
+                        set.add(word);
+                    }
+                    else if(set.contains(word)) {
+                        hits++;
+                    }
+                }
+                found[t] = hits;
+            });
+
+            double total = 1.0 * threadCount * operationsPerThread;
+            std::cout << "  " << threadCount << " thread(s): "
+                      << total / seconds / 1e6 << " Mops/s, final size "
+                      << set.size() << std::endl;
+        }
+    }
+
+
+    void benchmarkConcurrentHashSet()
+    {
+        benchmarkConcurrentSet("ConcurrentHashSet", 1, []() { return ConcurrentHashSet<std::string>{stringHash}; });
+    }
+
+
+    // The skip list is run once with the same mix as the hash set and once
+    // with a quarter of the operations being adds, which makes the threads
+    // race to link towers in next to one another.
+    void benchmarkConcurrentSkipListSet()
+    {
+        benchmarkConcurrentSet("ConcurrentSkipListSet", 1, []() { return ConcurrentSkipListSet<std::string>{}; });
+        benchmarkConcurrentSet("ConcurrentSkipListSet", 25, []() { return ConcurrentSkipListSet<std::string>{}; });
+    }
+
+
+    // timeLookups() looks up each of the given keys in the given set and
+    // returns the average time per lookup, in nanoseconds.
+    template <typename SetType, typename Key>
+    double timeLookups(const SetType& set, const std::vector<Key>& keys, unsigned int& hits)
+    {
+        hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for(const Key& key : keys) {
+            if(set.contains(key)) {
+                hits++;
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / keys.size();
+    }
+
+
+    // Compares lookups in an AVLSet with lookups in the FrozenOrderedSet
+    // it freezes into, at a few sizes.  Half of the lookups are misses.
+    void benchmarkFrozenOrderedSet()
+    {
+        constexpr unsigned int lookups = 2000000;
+
+        std::cout << "AVLSet vs. FrozenOrderedSet: " << lookups << " lookups" << std::endl;
+
+        for(unsigned int size=1000; size <= 4000000; size *= 4) {
+            std::vector<int> evens;
+            for(unsigned int i=0; i < size; i++) {
+                evens.push_back(static_cast<int>(i * 2));
+            }
+            AVLSet<int> tree = AVLSet<int>::buildFromSorted(evens.begin(), evens.end());
+            FrozenOrderedSet<int> frozen = tree.freeze();
+
+            std::vector<int> keys;
+            keys.reserve(lookups);
+            for(unsigned int i=0; i < lookups; i++) {
+                keys.push_back(static_cast<int>((i * 2654435761u) % (size * 2)));
+            }
+
+            unsigned int treeHits;
+            unsigned int frozenHits;
+            double treeTime = timeLookups(tree, keys, treeHits);
+            double frozenTime = timeLookups(frozen, keys, frozenHits);
+
+            std::cout << "  " << size << " elements: AVLSet " << treeTime << " ns, "
+                      << "FrozenOrderedSet " << frozenTime << " ns"
+                      << (treeHits == frozenHits ? "" : " (RESULTS DIFFER)") << std::endl;
+        }
+    }
+
+
+    // Compares lookups in an AVLSet with lookups in a SkipListSet holding
+    // the same elements, both in a scattered order and in ascending order
+    // (which the SkipListSet's fingers should make cheaper).  Half of the
+    // lookups are misses.
+    void benchmarkSkipListSet()
+    {
+        constexpr unsigned int lookups = 2000000;
+
+        std::cout << "AVLSet vs. SkipListSet: " << lookups << " lookups" << std::endl;
 
+        for(unsigned int size=1000; size <= 1000000; size *= 10) {
+            AVLSet<int> tree;
+            SkipListSet<int> skipList;
+            for(unsigned int i=0; i < size; i++) {
+                int element = static_cast<int>((i * 2654435761u) % size * 2);
+                tree.add(element);
+                skipList.add(element);
+            }
+
+            std::vector<int> scattered;
+            std::vector<int> ascending;
+            scattered.reserve(lookups);
+            ascending.reserve(lookups);
+            for(unsigned int i=0; i < lookups; i++) {
+                scattered.push_back(static_cast<int>((i * 2654435761u) % (size * 2)));
+                ascending.push_back(static_cast<int>(i % (size * 2)));
+            }
+
+            unsigned int treeHits;
+            unsigned int skipListHits;
+            double treeScattered = timeLookups(tree, scattered, treeHits);
+            double skipListScattered = timeLookups(skipList, scattered, skipListHits);
+            double treeAscending = timeLookups(tree, ascending, treeHits);
+            double skipListAscending = timeLookups(skipList, ascending, skipListHits);
+
+            std::cout << "  " << size << " elements: scattered AVLSet " << treeScattered
+                      << " ns, SkipListSet " << skipListScattered << " ns; ascending AVLSet "
+                      << treeAscending << " ns, SkipListSet " << skipListAscending << " ns"
+                      << (treeHits == skipListHits ? "" : " (RESULTS DIFFER)") << std::endl;
+        }
+    }
+
+
+    // Compares lookups of words in an AVLSet, a SkipListSet, and an
+    // UnrolledSkipListSet, in a scattered order.  Half of the lookups are
+    // misses.
+    void benchmarkUnrolledSkipListSet()
+    {
+        constexpr unsigned int lookups = 1000000;
+
+        std::cout << "AVLSet vs. SkipListSet vs. UnrolledSkipListSet: " << lookups
+                  << " lookups of words" << std::endl;
+
+        for(unsigned int size=1000; size <= 1000000; size *= 10) {
+            std::vector<std::string> present = makeWords(size, "w");
+            std::vector<std::string> absent = makeWords(size, "x");
+
+            AVLSet<std::string> tree;
+            SkipListSet<std::string> skipList;
+            UnrolledSkipListSet<std::string> unrolled;
+            for(const std::string& word : present) {
+                tree.add(word);
+                skipList.add(word);
+                unrolled.add(word);
+            }
+
+            std::vector<std::string> keys;
+            keys.reserve(lookups);
+            for(unsigned int i=0; i < lookups; i++) {
+                unsigned int j = (i * 2654435761u) % size;
+                keys.push_back(i % 2 == 0 ? present[j] : absent[j]);
+            }
+
+            unsigned int treeHits;
+            unsigned int skipListHits;
+            unsigned int unrolledHits;
+            double treeTime = timeLookups(tree, keys, treeHits);
+            double skipListTime = timeLookups(skipList, keys, skipListHits);
+            double unrolledTime = timeLookups(unrolled, keys, unrolledHits);
+
+            std::cout << "  " << size << " words: AVLSet " << treeTime << " ns, SkipListSet "
+                      << skipListTime << " ns, UnrolledSkipListSet " << unrolledTime << " ns ("
+                      << unrolled.levelCount() << " levels, " << unrolled.blocksOnLevel(0)
+                      << " blocks on level 0)"
+                      << (treeHits == skipListHits && treeHits == unrolledHits ? "" : " (RESULTS DIFFER)")
+                      << std::endl;
+        }
+    }
+
+
+    // Compares building a SkipListSet from a sorted dictionary by adding
+    // its words one at a time with building it with buildFromSorted().
+    void benchmarkSkipListSetBuild()
+    {
+        constexpr unsigned int dictionarySize = 1000000;
+
+        std::vector<std::string> words = makeWords(dictionarySize, "w");
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        auto start = std::chrono::steady_clock::now();
+        SkipListSet<std::string> added;
+        for(const std::string& word : words) {
+            added.add(word);
+        }
+        std::chrono::duration<double, std::milli> addTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        SkipListSet<std::string> built = SkipListSet<std::string>::buildFromSorted(words.begin(), words.end());
+        std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+
+        std::cout << "SkipListSet build from " << words.size() << " sorted words: add() "
+                  << addTime.count() << " ms, buildFromSorted() " << buildTime.count() << " ms"
+                  << (added.size() == built.size() ? "" : " (RESULTS DIFFER)") << std::endl;
+    }
+
+
+    // Times choosing a million tower heights with each kind of level
+    // tester, and then adding a million elements to a SkipListSet that
+    // uses it, which shows how much of the cost of add() is coin flipping
+    // and what a probability of 1/4 does to searches.
+    void benchmarkLevelTesters()
+    {
+        constexpr unsigned int count = 1000000;
+
+        std::cout << "Level testers: " << count << " heights, " << count << " adds" << std::endl;
+
+        auto run = [&](const std::string& name, auto makeTester) {
+            auto tester = makeTester();
+            unsigned int totalLevels = 0;
+            auto start = std::chrono::steady_clock::now();
+            for(unsigned int i=0; i < count; i++) {
+                totalLevels += tester->levelsToOccupy(static_cast<int>(i), 32);
+            }
+            std::chrono::duration<double, std::nano> heightTime = std::chrono::steady_clock::now() - start;
+
+            SkipListSet<int> s{makeTester()};
+            start = std::chrono::steady_clock::now();
+            for(unsigned int i=0; i < count; i++) {
+                s.add(static_cast<int>(i * 2654435761u));
+            }
+            std::chrono::duration<double, std::milli> addTime = std::chrono::steady_clock::now() - start;
+
+            std::cout << "  " << name << ": " << heightTime.count() / count << " ns per height ("
+                      << 1.0 * totalLevels / count << " levels on average), adds "
+                      << addTime.count() << " ms, " << s.levelCount() << " levels" << std::endl;
+        };
+
+        run("RandomSkipListLevelTester", []() { return std::make_unique<RandomSkipListLevelTester<int>>(); });
+        run("GeometricSkipListLevelTester (1/2)", []() { return std::make_unique<GeometricSkipListLevelTester<int>>(2); });
+        run("GeometricSkipListLevelTester (1/4)", []() { return std::make_unique<GeometricSkipListLevelTester<int>>(4); });
+    }
+}
+
+
+int main()
+{
+    benchmarkConcurrentHashSet();
+    benchmarkConcurrentSkipListSet();
+    benchmarkFrozenOrderedSet();
+    benchmarkSkipListSet();
+    benchmarkUnrolledSkipListSet();
+    benchmarkSkipListSetBuild();
+    benchmarkLevelTesters();
 
     return 0;
 }
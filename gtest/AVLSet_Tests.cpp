@@ -0,0 +1,405 @@
+// AVLSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the parts of AVLSet that go beyond what the sanity-
+// checking tests cover.
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+
+
+TEST(AVLSet_Tests, canLookUpStringViewsWithoutBuildingStrings)
+{
+    AVLSet<std::string> s1;
+    s1.add("HELLO");
+    s1.add("THERE");
+    s1.add("BOO");
+
+    std::string_view text = "HELLO THERE BOO";
+    EXPECT_TRUE(s1.containsKey(text.substr(0, 5)));
+    EXPECT_TRUE(s1.containsKey(text.substr(6, 5)));
+    EXPECT_TRUE(s1.containsKey(text.substr(12, 3)));
+    EXPECT_FALSE(s1.containsKey(text.substr(0, 4)));
+    EXPECT_FALSE(s1.containsKey(text.substr(1, 5)));
+}
+
+
+TEST(AVLSet_Tests, staysBalancedAfterManyAdds)
+{
+    AVLSet<int> s1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        s1.add((i * 7919) % 100000);
+        s1.add((i * 7919) % 100000);
+    }
+
+    EXPECT_EQ(100000, s1.size());
+    EXPECT_LE(s1.height(), 23);
+    for (int i = 0; i < 100000; ++i)
+    {
+        ASSERT_TRUE(s1.contains(i));
+    }
+    EXPECT_FALSE(s1.contains(-1));
+    EXPECT_FALSE(s1.contains(100000));
+}
+
+
+TEST(AVLSet_Tests, unbalancedTreesCanGrowDeeperThanAnyBalancedOne)
+{
+    AVLSet<std::string> s1{false};
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string word = std::to_string(100000 + i);
+        s1.add(word);
+        s1.add(word);
+    }
+
+    EXPECT_EQ(2000, s1.size());
+    EXPECT_EQ(1999, s1.height());
+    EXPECT_TRUE(s1.contains("101999"));
+    EXPECT_FALSE(s1.contains("102000"));
+}
+
+
+TEST(AVLSet_Tests, buildsPerfectlyBalancedTreesFromSortedRanges)
+{
+    std::vector<int> sorted;
+    for (int i = 0; i < 1000; ++i)
+    {
+        sorted.push_back(i);
+        if (i % 3 == 0)
+        {
+            sorted.push_back(i);
+        }
+    }
+
+    AVLSet<int> s1 = AVLSet<int>::buildFromSorted(sorted.begin(), sorted.end());
+
+    EXPECT_EQ(1000, s1.size());
+    EXPECT_EQ(9, s1.height());
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(s1.contains(i));
+    }
+
+    std::vector<int> visited;
+    s1.inorder([&](const int& i) { visited.push_back(i); });
+    EXPECT_EQ(1000, visited.size());
+    EXPECT_TRUE(std::is_sorted(visited.begin(), visited.end()));
+
+    s1.add(1000);
+    s1.add(-1);
+    EXPECT_EQ(1002, s1.size());
+    EXPECT_EQ(10, s1.height());
+}
+
+
+TEST(AVLSet_Tests, buildingFromAnUnsortedRangeStillWorks)
+{
+    std::vector<std::string> words{"C", "A", "B", "A"};
+    AVLSet<std::string> s1 = AVLSet<std::string>::buildFromSorted(words.begin(), words.end());
+    AVLSet<std::string> s2 = AVLSet<std::string>::buildFromSorted(words.end(), words.end());
+
+    EXPECT_EQ(3, s1.size());
+    EXPECT_EQ(1, s1.height());
+    EXPECT_TRUE(s1.contains("B"));
+    EXPECT_EQ(0, s2.size());
+    EXPECT_EQ(-1, s2.height());
+}
+
+
+TEST(AVLSet_Tests, ranksAndSelectsByPosition)
+{
+    AVLSet<int> s1;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(((i * 7919) % 1000) * 2);
+    }
+
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(static_cast<int>(i * 2), s1.select(i));
+        ASSERT_EQ(i, s1.rank(i * 2));
+        ASSERT_EQ(i + 1, s1.rank(i * 2 + 1));
+    }
+    EXPECT_EQ(0, s1.rank(-5));
+    EXPECT_THROW(s1.select(1000), std::out_of_range);
+
+    AVLSet<int> s2{s1};
+    s2.add(-1);
+    EXPECT_EQ(-1, s2.select(0));
+    EXPECT_EQ(1998, s2.select(1000));
+    EXPECT_EQ(0, s1.select(0));
+}
+
+
+TEST(AVLSet_Tests, findsBoundsAndVisitsRanges)
+{
+    std::vector<std::string> words{"pram", "pre", "precede", "prefix", "pretty", "prf", "prize"};
+    AVLSet<std::string> s1;
+    for (const std::string& word : words)
+    {
+        s1.add(word);
+    }
+
+    ASSERT_NE(nullptr, s1.lowerBound("pre"));
+    EXPECT_EQ("pre", *s1.lowerBound("pre"));
+    EXPECT_EQ("precede", *s1.upperBound("pre"));
+    EXPECT_EQ("pram", *s1.lowerBound("a"));
+    EXPECT_EQ(nullptr, s1.lowerBound("q"));
+    EXPECT_EQ(nullptr, s1.upperBound("prize"));
+
+    std::vector<std::string> visited;
+    s1.rangeVisit("pre", "prf", [&](const std::string& s) { visited.push_back(s); });
+    EXPECT_EQ((std::vector<std::string>{"pre", "precede", "prefix", "pretty"}), visited);
+
+    visited.clear();
+    s1.rangeVisit("pz", "zz", [&](const std::string& s) { visited.push_back(s); });
+    EXPECT_TRUE(visited.empty());
+}
+
+
+TEST(AVLSet_Tests, iteratesInAscendingOrder)
+{
+    AVLSet<int> s1;
+    for (int i = 0; i < 500; ++i)
+    {
+        s1.add((i * 7919) % 500);
+    }
+
+    int expected = 0;
+    for (int i : s1)
+    {
+        ASSERT_EQ(expected, i);
+        ++expected;
+    }
+    EXPECT_EQ(500, expected);
+    EXPECT_EQ(500, std::distance(s1.begin(), s1.end()));
+    EXPECT_EQ(250, *std::find(s1.begin(), s1.end(), 250));
+
+    AVLSet<int> s2;
+    EXPECT_TRUE(s2.begin() == s2.end());
+}
+
+
+// Descending adds leave every node without a right child, so if advancing
+// an iterator ever has to search again from the root, walking this tree
+// (and walking it repeatedly) takes quadratic time instead of linear.
+TEST(AVLSet_Tests, iteratesThroughDegenerateTreesInLinearTime)
+{
+    AVLSet<int> s1{false};
+    for (int i = 5000; i > 0; --i)
+    {
+        s1.add(i);
+    }
+    EXPECT_EQ(4999, s1.height());
+
+    for (int walk = 0; walk < 400; ++walk)
+    {
+        int expected = 1;
+        for (int i : s1)
+        {
+            ASSERT_EQ(expected, i);
+            ++expected;
+        }
+        ASSERT_EQ(5001, expected);
+    }
+
+    AVLSet<int>::const_iterator i = s1.begin();
+    std::advance(i, 2500);
+    AVLSet<int>::const_iterator j = i;
+    EXPECT_EQ(2501, *j);
+    EXPECT_EQ(2500, std::distance(j, s1.end()));
+    EXPECT_EQ(2501, *i);
+}
+
+
+TEST(AVLSet_Tests, templatedVisitorsMatchTheStdFunctionOnes)
+{
+    AVLSet<int> s1{false};
+    for (int i : {50, 30, 70, 20, 40, 60, 80, 35, 65})
+    {
+        s1.add(i);
+    }
+
+    std::vector<int> pre, in, post;
+    s1.preorder([&](const int& i) { pre.push_back(i); });
+    s1.inorder([&](const int& i) { in.push_back(i); });
+    s1.postorder([&](const int& i) { post.push_back(i); });
+
+    std::vector<int> preF, inF, postF;
+    s1.preorder(AVLSet<int>::VisitFunction{[&](const int& i) { preF.push_back(i); }});
+    s1.inorder(AVLSet<int>::VisitFunction{[&](const int& i) { inF.push_back(i); }});
+    s1.postorder(AVLSet<int>::VisitFunction{[&](const int& i) { postF.push_back(i); }});
+
+    EXPECT_EQ((std::vector<int>{50, 30, 20, 40, 35, 70, 60, 65, 80}), pre);
+    EXPECT_EQ((std::vector<int>{20, 30, 35, 40, 50, 60, 65, 70, 80}), in);
+    EXPECT_EQ((std::vector<int>{20, 35, 40, 30, 65, 60, 80, 70, 50}), post);
+    EXPECT_EQ(pre, preF);
+    EXPECT_EQ(in, inF);
+    EXPECT_EQ(post, postF);
+}
+
+
+namespace
+{
+    // Builds a set of the multiples of step below limit, in a scrambled
+    // order, so that the tree's shape doesn't depend on the order.
+    AVLSet<int> multiples(int step, int limit, bool shouldBalance = true)
+    {
+        AVLSet<int> s{shouldBalance};
+        int count = limit / step;
+        for (int i = 0; i < count; ++i)
+        {
+            s.add(((i * 7919) % count) * step);
+        }
+        return s;
+    }
+
+
+    void expectContentsAndShape(const AVLSet<int>& s, const std::vector<int>& expected)
+    {
+        ASSERT_EQ(expected.size(), s.size());
+        EXPECT_TRUE(std::equal(s.begin(), s.end(), expected.begin()));
+        for (unsigned int i = 0; i < expected.size(); i += 97)
+        {
+            ASSERT_EQ(expected[i], s.select(i));
+        }
+
+        int limit = 1;
+        for (unsigned int n = expected.size() + 2; n > 1; n /= 2)
+        {
+            limit += 1;
+        }
+        EXPECT_LE(s.height(), limit * 3 / 2);
+    }
+}
+
+
+TEST(AVLSet_Tests, setOperationsMatchElementwiseOnes)
+{
+    for (int limit : {600, 120000})
+    {
+        AVLSet<int> twos = multiples(2, limit);
+        AVLSet<int> threes = multiples(3, limit);
+
+        std::vector<int> unionOf, intersectionOf, differenceOf;
+        for (int i = 0; i < limit; ++i)
+        {
+            bool inTwos = i % 2 == 0;
+            bool inThrees = i % 3 == 0;
+            if (inTwos || inThrees)
+            {
+                unionOf.push_back(i);
+            }
+            if (inTwos && inThrees)
+            {
+                intersectionOf.push_back(i);
+            }
+            if (inTwos && !inThrees)
+            {
+                differenceOf.push_back(i);
+            }
+        }
+
+        AVLSet<int> s1{twos};
+        s1.unionWith(threes);
+        expectContentsAndShape(s1, unionOf);
+
+        AVLSet<int> s2{twos};
+        s2.intersectWith(threes);
+        expectContentsAndShape(s2, intersectionOf);
+
+        AVLSet<int> s3{twos};
+        s3.differenceWith(threes);
+        expectContentsAndShape(s3, differenceOf);
+
+        s3.add(-1);
+        EXPECT_TRUE(s3.contains(-1));
+        EXPECT_EQ(limit / 2, twos.size());
+    }
+}
+
+
+TEST(AVLSet_Tests, setOperationsWorkWithoutBalancing)
+{
+    AVLSet<int> s1 = multiples(2, 100, false);
+    AVLSet<int> s2 = multiples(3, 100);
+
+    s1.unionWith(s2);
+    EXPECT_EQ(66, s1.size());
+    s1.intersectWith(s2);
+    EXPECT_EQ(33, s1.size());
+    s1.differenceWith(multiples(6, 100));
+    EXPECT_EQ(17, s1.size());
+    EXPECT_TRUE(s1.contains(3));
+    EXPECT_FALSE(s1.contains(6));
+
+    s1.differenceWith(s1);
+    EXPECT_EQ(0, s1.size());
+}
+
+
+TEST(AVLSet_Tests, copiesAndDestroysLargeTrees)
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 60000; ++i)
+    {
+        words.push_back(std::to_string(1000000 + i));
+    }
+
+    AVLSet<std::string> s1 = AVLSet<std::string>::buildFromSorted(words.begin(), words.end());
+    {
+        AVLSet<std::string> s2{s1};
+        EXPECT_EQ(s1.height(), s2.height());
+        EXPECT_TRUE(std::equal(s1.begin(), s1.end(), s2.begin()));
+
+        s2.add("HELLO");
+        EXPECT_EQ(60001, s2.size());
+        EXPECT_EQ("1030000", s2.select(30000));
+    }
+    EXPECT_EQ(60000, s1.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+}
+
+
+TEST(AVLSet_Tests, copiesAndDestroysDegenerateTreesWithoutRecursing)
+{
+    AVLSet<std::string> s1{false};
+    for (int i = 0; i < 20000; ++i)
+    {
+        s1.add(std::to_string(100000 + i));
+    }
+
+    AVLSet<std::string> s2{s1};
+    EXPECT_EQ(19999, s2.height());
+    EXPECT_EQ(20000, s2.size());
+    EXPECT_TRUE(s2.contains("119999"));
+}
+
+
+TEST(AVLSet_Tests, destroysOldContentsInTheBackground)
+{
+    AVLSet<std::string> s1;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    std::future<void> done = s1.destroyAsync();
+    EXPECT_EQ(0, s1.size());
+    EXPECT_FALSE(s1.contains("1"));
+
+    s1.add("HELLO");
+    done.wait();
+    EXPECT_EQ(1, s1.size());
+    EXPECT_TRUE(s1.contains("HELLO"));
+}
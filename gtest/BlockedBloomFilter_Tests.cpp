@@ -0,0 +1,119 @@
+// BlockedBloomFilter_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for BlockedBloomFilter.
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <gtest/gtest.h>
+#include "BlockedBloomFilter.hpp"
+
+
+TEST(BlockedBloomFilter_Tests, neverForgetsAnAddedString)
+{
+    BlockedBloomFilter f{10000};
+    for (int i = 0; i < 10000; ++i)
+    {
+        f.add("word" + std::to_string(i));
+    }
+
+    EXPECT_EQ(10000, f.size());
+    for (int i = 0; i < 10000; ++i)
+    {
+        ASSERT_TRUE(f.mayContain("word" + std::to_string(i)));
+    }
+}
+
+
+TEST(BlockedBloomFilter_Tests, falsePositiveRateIsNearTheEstimate)
+{
+    BlockedBloomFilter f{20000};
+    for (int i = 0; i < 20000; ++i)
+    {
+        f.add("in" + std::to_string(i));
+    }
+
+    int falsePositives = 0;
+    constexpr int trials = 100000;
+    for (int i = 0; i < trials; ++i)
+    {
+        if (f.mayContain("out" + std::to_string(i)))
+        {
+            ++falsePositives;
+        }
+    }
+
+    double measured = 1.0 * falsePositives / trials;
+    double estimated = f.falsePositiveRate();
+    EXPECT_LT(estimated, 0.02);
+    EXPECT_GT(estimated, 0.002);
+    EXPECT_NEAR(estimated, measured, estimated / 2);
+}
+
+
+// The words are like the ones a WordChecker's dictionary holds, and the
+// lookups are like its suggestions: each word with one letter replaced, and
+// with an extra letter on the end.
+TEST(BlockedBloomFilter_Tests, defaultFalsePositiveRateOnADictionaryIsAsDocumented)
+{
+    constexpr unsigned int dictionarySize = 100000;
+    BlockedBloomFilter f{dictionarySize};
+    for (unsigned int i = 0; i < dictionarySize; ++i)
+    {
+        f.add("w" + std::to_string(i * 2654435761u));
+    }
+
+    int falsePositives = 0;
+    int trials = 0;
+    for (unsigned int i = 0; i < dictionarySize; ++i)
+    {
+        std::string word = "w" + std::to_string(i * 2654435761u);
+        for (std::size_t j = 0; j < word.size(); ++j)
+        {
+            std::string misspelled = word;
+            misspelled[j] = misspelled[j] == 'z' ? 'y' : 'z';
+            falsePositives += f.mayContain(misspelled) ? 1 : 0;
+            ++trials;
+        }
+        falsePositives += f.mayContain(word + "s") ? 1 : 0;
+        ++trials;
+    }
+
+    double measured = 1.0 * falsePositives / trials;
+    EXPECT_GT(measured, 0.01);
+    EXPECT_LT(measured, 0.015);
+    EXPECT_GT(measured, f.falsePositiveRate());
+}
+
+
+TEST(BlockedBloomFilter_Tests, memoryIsWholeCacheLineBlocks)
+{
+    BlockedBloomFilter f{1000, 8};
+
+    EXPECT_EQ(1024u, f.memoryBytes());
+    EXPECT_EQ(6u, f.hashCount());
+    EXPECT_EQ(0.0, f.falsePositiveRate());
+}
+
+
+TEST(BlockedBloomFilter_Tests, copiesAndMovesAreIndependent)
+{
+    BlockedBloomFilter f1{100};
+    f1.add("alpha");
+
+    BlockedBloomFilter f2{f1};
+    f2.add("beta");
+
+    BlockedBloomFilter f3{std::move(f2)};
+
+    EXPECT_TRUE(f1.mayContain("alpha"));
+    EXPECT_EQ(1, f1.size());
+    EXPECT_TRUE(f3.mayContain("alpha"));
+    EXPECT_TRUE(f3.mayContain("beta"));
+    EXPECT_EQ(2, f3.size());
+    EXPECT_EQ(0u, f2.memoryBytes());
+    EXPECT_TRUE(f2.mayContain("anything"));
+}
@@ -0,0 +1,84 @@
+// CompactAVLSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for CompactAVLSet.
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "CompactAVLSet.hpp"
+
+
+TEST(CompactAVLSet_Tests, behavesLikeASet)
+{
+    CompactAVLSet<int> s1;
+    Set<int>& ss1 = s1;
+    for (int i = 0; i < 50000; ++i)
+    {
+        ss1.add((i * 7919) % 50000);
+        ss1.add((i * 7919) % 50000);
+    }
+
+    EXPECT_TRUE(ss1.isImplemented());
+    EXPECT_EQ(50000, ss1.size());
+    EXPECT_LE(s1.height(), 22);
+    for (int i = 0; i < 50000; ++i)
+    {
+        ASSERT_TRUE(ss1.contains(i));
+    }
+    EXPECT_FALSE(ss1.contains(50000));
+}
+
+
+TEST(CompactAVLSet_Tests, visitsElementsInOrder)
+{
+    CompactAVLSet<std::string> s1;
+    s1.add("C");
+    s1.add("A");
+    s1.add("D");
+    s1.add("B");
+
+    std::vector<std::string> visited;
+    s1.inorder([&](const std::string& s) { visited.push_back(s); });
+
+    EXPECT_EQ((std::vector<std::string>{"A", "B", "C", "D"}), visited);
+    EXPECT_TRUE(s1.containsKey(std::string_view{"D"}));
+}
+
+
+TEST(CompactAVLSet_Tests, linksAreSmallerThanPointers)
+{
+    CompactAVLSet<int> s1;
+    s1.reserve(1000);
+
+    EXPECT_EQ(1000 * (sizeof(int) + 12), s1.memoryBytes());
+}
+
+
+TEST(CompactAVLSet_Tests, copiesAndMovesAreIndependent)
+{
+    CompactAVLSet<std::string> s1;
+    for (int i = 0; i < 300; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    CompactAVLSet<std::string> s2{s1};
+    s2.add("HELLO");
+
+    CompactAVLSet<std::string> s3{std::move(s2)};
+    s1 = s3;
+    s3.add("THERE");
+
+    EXPECT_EQ(301, s1.size());
+    EXPECT_TRUE(s1.contains("HELLO"));
+    EXPECT_FALSE(s1.contains("THERE"));
+    EXPECT_EQ(302, s3.size());
+    EXPECT_TRUE(s3.contains("299"));
+    EXPECT_EQ(0, s2.size());
+    EXPECT_FALSE(s2.contains("HELLO"));
+}
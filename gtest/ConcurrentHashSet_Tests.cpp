@@ -0,0 +1,200 @@
+// ConcurrentHashSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for ConcurrentHashSet, including some that hammer one set
+// from several threads at once.
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ConcurrentHashSet.hpp"
+
+
+namespace
+{
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+}
+
+
+TEST(ConcurrentHashSet_Tests, behavesLikeASet)
+{
+    ConcurrentHashSet<int> s1{identityHash};
+    Set<int>& ss1 = s1;
+    ss1.add(11);
+    ss1.add(1);
+    ss1.add(5);
+    ss1.add(5);
+
+    EXPECT_TRUE(ss1.isImplemented());
+    EXPECT_EQ(3, ss1.size());
+    EXPECT_TRUE(ss1.contains(11));
+    EXPECT_TRUE(ss1.contains(1));
+    EXPECT_TRUE(ss1.contains(5));
+    EXPECT_FALSE(ss1.contains(2));
+}
+
+
+TEST(ConcurrentHashSet_Tests, copiesAndMovesAreIndependent)
+{
+    ConcurrentHashSet<std::string> s1{[](const std::string& s) { return static_cast<unsigned int>(s.size()); }};
+    for (int i = 0; i < 500; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    ConcurrentHashSet<std::string> s2{s1};
+    s2.add("HELLO");
+
+    ConcurrentHashSet<std::string> s3{std::move(s2)};
+    s3.reclaim();
+
+    EXPECT_EQ(500, s1.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+    EXPECT_EQ(501, s3.size());
+    EXPECT_TRUE(s3.contains("HELLO"));
+    EXPECT_TRUE(s3.contains("499"));
+    EXPECT_EQ(0, s2.size());
+}
+
+
+TEST(ConcurrentHashSet_Tests, concurrentAddsAreAllKept)
+{
+    constexpr int threadCount = 8;
+    constexpr int perThread = 5000;
+    ConcurrentHashSet<int> s1{identityHash};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            // Neighboring threads overlap by half, so duplicates race, too.
+            for (int i = 0; i < perThread; ++i)
+            {
+                s1.add(t * perThread / 2 + i);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    int expected = (threadCount + 1) * perThread / 2;
+    EXPECT_EQ(expected, s1.size());
+    for (int i = 0; i < expected; ++i)
+    {
+        ASSERT_TRUE(s1.contains(i));
+    }
+    EXPECT_FALSE(s1.contains(expected));
+}
+
+
+TEST(ConcurrentHashSet_Tests, readersAlwaysSeeEarlierElementsDuringResizes)
+{
+    constexpr int total = 20000;
+    ConcurrentHashSet<int> s1{identityHash};
+    std::atomic<int> published{0};
+    std::atomic<bool> missed{false};
+
+    std::thread writer{[&]()
+    {
+        for (int i = 0; i < total; ++i)
+        {
+            s1.add(i);
+            published.store(i + 1, std::memory_order_release);
+        }
+    }};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&, r]()
+        {
+            int checked = 0;
+            while (published.load(std::memory_order_acquire) < total)
+            {
+                int limit = published.load(std::memory_order_acquire);
+                if (limit > 0 && !s1.contains((checked++ * 7 + r) % limit))
+                {
+                    missed.store(true);
+                }
+            }
+        });
+    }
+
+    writer.join();
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_FALSE(missed.load());
+    EXPECT_EQ(total, s1.size());
+}
+
+
+TEST(ConcurrentHashSet_Tests, retiredArraysAreDeletedByTheAddThatRetiresThem)
+{
+    ConcurrentHashSet<int> s1{identityHash};
+    for (int i = 0; i < 5000; ++i)
+    {
+        s1.add(i);
+        ASSERT_EQ(0, s1.retiredTables());
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i));
+    }
+    EXPECT_EQ(0, s1.retiredTables());
+}
+
+
+TEST(ConcurrentHashSet_Tests, retiredArraysAreDeletedByLaterAddsWhileReadersKeepReading)
+{
+    constexpr int total = 20000;
+    ConcurrentHashSet<int> s1{identityHash};
+    std::atomic<bool> done{false};
+    std::atomic<bool> missed{false};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&, r]()
+        {
+            int checked = 0;
+            while (!done.load())
+            {
+                if (s1.contains(total + (checked++ * 7 + r) % total))
+                {
+                    missed.store(true);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < total; ++i)
+    {
+        s1.add(i);
+    }
+    for (int i = 0; i < 1000 && s1.retiredTables() != 0; ++i)
+    {
+        std::this_thread::yield();
+        s1.add(-1 - i);
+    }
+    EXPECT_EQ(0, s1.retiredTables());
+
+    done.store(true);
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_FALSE(missed.load());
+}
@@ -0,0 +1,157 @@
+// ConcurrentSkipListSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for ConcurrentSkipListSet, including some that hammer one set
+// from several threads at once.
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ConcurrentSkipListSet.hpp"
+
+
+TEST(ConcurrentSkipListSet_Tests, behavesLikeASet)
+{
+    ConcurrentSkipListSet<int> s1;
+    Set<int>& ss1 = s1;
+    for (int i = 0; i < 5000; ++i)
+    {
+        ss1.add((i * 7919) % 5000);
+        ss1.add((i * 7919) % 5000);
+    }
+
+    EXPECT_TRUE(ss1.isImplemented());
+    EXPECT_EQ(5000, ss1.size());
+    EXPECT_GT(s1.levelCount(), 1);
+    for (int i = -1; i <= 5000; ++i)
+    {
+        ASSERT_EQ(i >= 0 && i < 5000, ss1.contains(i));
+    }
+}
+
+
+TEST(ConcurrentSkipListSet_Tests, rangeVisitFindsPrefixes)
+{
+    ConcurrentSkipListSet<std::string> s1;
+    for (const char* word : {"pray", "pre", "prefix", "press", "prey", "prf", "apple", "zoo"})
+    {
+        s1.add(word);
+    }
+
+    std::vector<std::string> visited;
+    s1.rangeVisit("pre", "prf", [&](const std::string& s) { visited.push_back(s); });
+    EXPECT_EQ((std::vector<std::string>{"pre", "prefix", "press", "prey"}), visited);
+}
+
+
+TEST(ConcurrentSkipListSet_Tests, copiesAndMovesAreIndependent)
+{
+    ConcurrentSkipListSet<std::string> s1;
+    for (int i = 0; i < 500; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    ConcurrentSkipListSet<std::string> s2{s1};
+    s2.add("HELLO");
+    EXPECT_EQ(s1.levelCount(), s2.levelCount());
+
+    ConcurrentSkipListSet<std::string> s3{std::move(s2)};
+
+    EXPECT_EQ(500, s1.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+    EXPECT_EQ(501, s3.size());
+    EXPECT_TRUE(s3.contains("HELLO"));
+    EXPECT_TRUE(s3.contains("499"));
+    EXPECT_EQ(0, s2.size());
+    EXPECT_FALSE(s2.contains("499"));
+
+    s2 = s3;
+    EXPECT_EQ(501, s2.size());
+    EXPECT_TRUE(s2.contains("0"));
+}
+
+
+TEST(ConcurrentSkipListSet_Tests, concurrentAddsAreAllKeptInOrder)
+{
+    constexpr int threadCount = 8;
+    constexpr int perThread = 5000;
+    ConcurrentSkipListSet<int> s1;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            // Neighboring threads overlap by half, so duplicates race, too.
+            for (int i = 0; i < perThread; ++i)
+            {
+                s1.add(t * perThread / 2 + i);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    int expected = (threadCount + 1) * perThread / 2;
+    EXPECT_EQ(expected, s1.size());
+    for (int i = 0; i < expected; ++i)
+    {
+        ASSERT_TRUE(s1.contains(i));
+    }
+    EXPECT_FALSE(s1.contains(expected));
+
+    int next = 0;
+    s1.rangeVisit(0, expected, [&](const int& i) { ASSERT_EQ(next++, i); });
+    EXPECT_EQ(expected, next);
+}
+
+
+TEST(ConcurrentSkipListSet_Tests, readersAlwaysSeeEarlierElementsWhileOthersAdd)
+{
+    constexpr int total = 20000;
+    ConcurrentSkipListSet<int> s1;
+    std::atomic<int> published{0};
+    std::atomic<bool> missed{false};
+
+    std::thread writer{[&]()
+    {
+        for (int i = 0; i < total; ++i)
+        {
+            s1.add((i * 7919) % total);
+            published.store(i + 1, std::memory_order_release);
+        }
+    }};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&, r]()
+        {
+            int checked = 0;
+            while (published.load(std::memory_order_acquire) < total)
+            {
+                int limit = published.load(std::memory_order_acquire);
+                if (limit > 0 && !s1.contains((((checked++ * 7 + r) % limit) * 7919) % total))
+                {
+                    missed.store(true);
+                }
+            }
+        });
+    }
+
+    writer.join();
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_FALSE(missed.load());
+    EXPECT_EQ(total, s1.size());
+}
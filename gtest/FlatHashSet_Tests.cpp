@@ -0,0 +1,200 @@
+// FlatHashSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the open-addressed FlatHashSet.
+
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+#include "FlatHashSet.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+
+
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    unsigned int stringHash(const std::string& s)
+    {
+        unsigned int h = 2166136261u;
+        for (char c : s)
+        {
+            h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return h;
+    }
+}
+
+
+TEST(FlatHashSet_Tests, inheritFromSet)
+{
+    FlatHashSet<int> s1{zeroHash<int>};
+    Set<int>& ss1 = s1;
+    EXPECT_EQ(0, ss1.size());
+    EXPECT_TRUE(ss1.isImplemented());
+}
+
+
+TEST(FlatHashSet_Tests, containsOnlyElementsAdded)
+{
+    FlatHashSet<int> s1{identityHash};
+    s1.add(11);
+    s1.add(1);
+    s1.add(5);
+    s1.add(5);
+
+    EXPECT_EQ(3, s1.size());
+    EXPECT_TRUE(s1.contains(11));
+    EXPECT_TRUE(s1.contains(1));
+    EXPECT_TRUE(s1.contains(5));
+    EXPECT_FALSE(s1.contains(21));
+    EXPECT_FALSE(s1.contains(2));
+}
+
+
+TEST(FlatHashSet_Tests, growsWhileKeepingAllElements)
+{
+    FlatHashSet<int> s1{identityHash};
+    for (int i = 0; i < 5000; ++i)
+    {
+        s1.add(i * 7);
+    }
+
+    EXPECT_EQ(5000, s1.size());
+    EXPECT_LE(5000 * 8, s1.capacity() * 7);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_FALSE(s1.contains(i * 7 + 1));
+    }
+}
+
+
+TEST(FlatHashSet_Tests, worksWhenEveryElementCollides)
+{
+    FlatHashSet<int> s1{zeroHash<int>};
+    for (int i = 0; i < 200; ++i)
+    {
+        s1.add(i);
+    }
+
+    EXPECT_EQ(200, s1.size());
+    for (int i = 0; i < 200; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i));
+    }
+    EXPECT_FALSE(s1.contains(200));
+}
+
+
+TEST(FlatHashSet_Tests, worksWhenHashesDifferOnlyInTheirHighBits)
+{
+    FlatHashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i) << 20; }};
+    for (int i = 0; i < 4096; ++i)
+    {
+        s1.add(i);
+    }
+
+    EXPECT_EQ(4096, s1.size());
+    for (int i = 0; i < 4096; ++i)
+    {
+        ASSERT_TRUE(s1.contains(i));
+    }
+    EXPECT_FALSE(s1.contains(4096));
+}
+
+
+TEST(FlatHashSet_Tests, growingNeverHashesAnElementAgain)
+{
+    unsigned int hashCalls = 0;
+    FlatHashSet<std::string> s1{[&](const std::string& s)
+    {
+        ++hashCalls;
+        return stringHash(s);
+    }};
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    EXPECT_EQ(5000, hashCalls);
+    EXPECT_LE(5000 * 8, s1.capacity() * 7);
+    for (int i = 0; i < 5000; ++i)
+    {
+        ASSERT_TRUE(s1.contains(std::to_string(i)));
+    }
+    EXPECT_FALSE(s1.contains("5000"));
+}
+
+
+TEST(FlatHashSet_Tests, copiesAreIndependent)
+{
+    FlatHashSet<std::string> s1{stringHash};
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    FlatHashSet<std::string> s2{s1};
+    s2.add("BOO");
+
+    FlatHashSet<std::string> s3{zeroHash<std::string>};
+    s3 = s2;
+
+    EXPECT_EQ(2, s1.size());
+    EXPECT_FALSE(s1.contains("BOO"));
+    EXPECT_EQ(3, s2.size());
+    EXPECT_TRUE(s2.contains("BOO"));
+    EXPECT_EQ(3, s3.size());
+    EXPECT_TRUE(s3.contains("HELLO"));
+}
+
+
+TEST(FlatHashSet_Tests, movedFromSetIsEmptyAndUsable)
+{
+    FlatHashSet<std::string> s1{stringHash};
+    s1.add("HELLO");
+
+    FlatHashSet<std::string> s2{std::move(s1)};
+    EXPECT_TRUE(s2.contains("HELLO"));
+
+    EXPECT_EQ(0, s1.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+    s1.add("THERE");
+    EXPECT_TRUE(s1.contains("THERE"));
+}
+
+
+TEST(FlatHashSet_Tests, canLookUpStringViewsWithoutBuildingStrings)
+{
+    FlatHashSet<std::string> s1{stringHash};
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    auto viewHash = [](std::string_view s)
+    {
+        unsigned int h = 2166136261u;
+        for (char c : s)
+        {
+            h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return h;
+    };
+
+    std::string_view text = "HELLO THERE BOO";
+    EXPECT_TRUE(s1.containsKey(text.substr(0, 5), viewHash));
+    EXPECT_TRUE(s1.containsKey(text.substr(6, 5), viewHash));
+    EXPECT_FALSE(s1.containsKey(text.substr(12, 3), viewHash));
+}
@@ -0,0 +1,83 @@
+// FrozenOrderedSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for FrozenOrderedSet and AVLSet::freeze().
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "FrozenOrderedSet.hpp"
+
+
+TEST(FrozenOrderedSet_Tests, findsExactlyTheElementsOfEverySize)
+{
+    for (int n = 0; n <= 70; ++n)
+    {
+        std::vector<int> odds;
+        for (int i = 0; i < n; ++i)
+        {
+            odds.push_back(i * 2 + 1);
+        }
+
+        FrozenOrderedSet<int> s1{odds.begin(), odds.end()};
+        ASSERT_EQ(n, s1.size());
+        for (int i = -1; i <= n * 2 + 1; ++i)
+        {
+            ASSERT_EQ(i % 2 != 0 && i > 0 && i < n * 2, s1.contains(i)) << n << " " << i;
+        }
+    }
+}
+
+
+TEST(FrozenOrderedSet_Tests, freezesAnAVLSet)
+{
+    AVLSet<std::string> s1;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(std::to_string(i * 3));
+    }
+
+    FrozenOrderedSet<std::string> f1 = s1.freeze();
+    Set<std::string>& ff1 = f1;
+
+    EXPECT_TRUE(ff1.isImplemented());
+    EXPECT_EQ(1000, ff1.size());
+    for (int i = 0; i < 3000; ++i)
+    {
+        ASSERT_EQ(i % 3 == 0, ff1.contains(std::to_string(i)));
+    }
+    EXPECT_TRUE(f1.containsKey(std::string_view{"2997"}));
+    EXPECT_FALSE(f1.containsKey(std::string_view{"2998"}));
+}
+
+
+TEST(FrozenOrderedSet_Tests, cannotBeAddedTo)
+{
+    std::vector<int> elements{1, 2, 3};
+    FrozenOrderedSet<int> s1{elements.begin(), elements.end()};
+
+    EXPECT_THROW(s1.add(4), FrozenOrderedSetException);
+    EXPECT_FALSE(s1.contains(4));
+}
+
+
+TEST(FrozenOrderedSet_Tests, copiesAndMovesAreIndependent)
+{
+    std::vector<int> elements{1, 2, 3};
+    FrozenOrderedSet<int> s1{elements.begin(), elements.end()};
+    FrozenOrderedSet<int> s2{s1};
+    FrozenOrderedSet<int> s3{std::move(s2)};
+    FrozenOrderedSet<int> s4;
+    s4 = s3;
+
+    EXPECT_TRUE(s1.contains(2));
+    EXPECT_TRUE(s3.contains(3));
+    EXPECT_TRUE(s4.contains(1));
+    EXPECT_EQ(0, s2.size());
+    EXPECT_FALSE(s2.contains(1));
+}
@@ -0,0 +1,334 @@
+// HashSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the parts of HashSet that go beyond what the sanity-
+// checking tests cover.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+#include "HashSet.hpp"
+#include "StringHashers.hpp"
+
+
+namespace
+{
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    struct CopyCountingHash
+    {
+        explicit CopyCountingHash(int* copies)
+            : copies{copies}
+        {
+        }
+
+        CopyCountingHash(const CopyCountingHash& h)
+            : copies{h.copies}
+        {
+            ++*copies;
+        }
+
+        CopyCountingHash& operator=(const CopyCountingHash&) = default;
+
+        unsigned int operator()(std::string_view s) const
+        {
+            return static_cast<unsigned int>(s.size());
+        }
+
+        int* copies;
+    };
+}
+
+
+TEST(HashSet_Tests, copiesAreIndependent)
+{
+    HashSet<int> s1{identityHash};
+    s1.add(1);
+    s1.add(2);
+
+    HashSet<int> s2{s1};
+    s2.add(3);
+
+    HashSet<int> s3{identityHash};
+    s3 = s2;
+    s3.add(4);
+
+    EXPECT_EQ(2, s1.size());
+    EXPECT_FALSE(s1.contains(3));
+    EXPECT_EQ(3, s2.size());
+    EXPECT_FALSE(s2.contains(4));
+    EXPECT_EQ(4, s3.size());
+    EXPECT_TRUE(s3.contains(1));
+}
+
+
+TEST(HashSet_Tests, incrementalResizeKeepsEveryElementReachable)
+{
+    HashSet<int> s1{identityHash, true};
+    bool sawResize = false;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i);
+        sawResize = sawResize || s1.isResizing();
+
+        for (int j = 0; j <= i; j += 37)
+        {
+            ASSERT_TRUE(s1.contains(j));
+        }
+        ASSERT_FALSE(s1.contains(i + 1));
+    }
+
+    EXPECT_TRUE(sawResize);
+    EXPECT_EQ(1000, s1.size());
+}
+
+
+TEST(HashSet_Tests, incrementalResizeReportsFinalIndexes)
+{
+    HashSet<int> s1{identityHash, true};
+
+    // The 9th element crosses the 0.8 limit for 10 cells, so the set is
+    // now moving from 10 cells to 20.
+    for (int i = 0; i < 9; ++i)
+    {
+        s1.add(i * 10);
+    }
+    ASSERT_TRUE(s1.isResizing());
+
+    unsigned int total = 0;
+    for (unsigned int index = 0; index < 20; ++index)
+    {
+        total += s1.elementsAtIndex(index);
+    }
+
+    EXPECT_EQ(9, total);
+    EXPECT_EQ(5, s1.elementsAtIndex(0));
+    EXPECT_EQ(4, s1.elementsAtIndex(10));
+    EXPECT_TRUE(s1.isElementAtIndex(80, 0));
+    EXPECT_TRUE(s1.isElementAtIndex(70, 10));
+    EXPECT_FALSE(s1.isElementAtIndex(70, 0));
+}
+
+
+TEST(HashSet_Tests, copyOfResizingSetIsComplete)
+{
+    HashSet<int> s1{identityHash, true};
+    for (int i = 0; i < 9; ++i)
+    {
+        s1.add(i);
+    }
+    ASSERT_TRUE(s1.isResizing());
+
+    HashSet<int> s2{s1};
+    EXPECT_FALSE(s2.isResizing());
+    for (int i = 0; i < 9; ++i)
+    {
+        EXPECT_TRUE(s2.contains(i));
+    }
+}
+
+
+TEST(HashSet_Tests, resizingDoesNotRehashElements)
+{
+    unsigned int calls = 0;
+    HashSet<std::string> s1{[&](const std::string& s) { ++calls; return static_cast<unsigned int>(s.size()); }};
+
+    std::string word;
+    for (int i = 0; i < 100; ++i)
+    {
+        word += 'a';
+        s1.add(word);
+    }
+
+    EXPECT_EQ(100, calls);
+    EXPECT_EQ(100, s1.size());
+    EXPECT_EQ(1, s1.elementsAtIndex(37));
+    EXPECT_TRUE(s1.isElementAtIndex(std::string(37, 'a'), 37));
+}
+
+
+TEST(HashSet_Tests, canLookUpStringViewsWithoutBuildingStrings)
+{
+    auto hash = [](std::string_view s) { return static_cast<unsigned int>(s.size()); };
+    HashSet<std::string> s1{[&](const std::string& s) { return hash(s); }};
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    std::string_view text = "HELLO THERE BOO";
+    EXPECT_TRUE(s1.containsKey(text.substr(0, 5), hash));
+    EXPECT_TRUE(s1.containsKey(text.substr(6, 5), hash));
+    EXPECT_FALSE(s1.containsKey(text.substr(12, 3), hash));
+    EXPECT_FALSE(s1.containsKey(text.substr(1, 5), hash));
+}
+
+
+TEST(HashSet_Tests, keyLookupsNeverCopyTheHasher)
+{
+    int copies = 0;
+    HashSet<std::string, CopyCountingHash> s1{CopyCountingHash{&copies}};
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    CopyCountingHash hash{&copies};
+    int copiesBefore = copies;
+    std::string_view text = "HELLO THERE BOO";
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(s1.containsKey(text.substr(0, 5)));
+        ASSERT_TRUE(s1.containsKey(text.substr(6, 5), hash));
+        ASSERT_FALSE(s1.containsKey(text.substr(12, 3)));
+    }
+    EXPECT_EQ(copiesBefore, copies);
+}
+
+
+TEST(HashSet_Tests, reserveSizesTheArrayOnce)
+{
+    HashSet<int> s1{identityHash};
+    s1.add(1);
+    s1.reserve(100);
+
+    // 10 * 2^4 = 160 is the first doubling with room for 100 at 0.8.
+    EXPECT_EQ(1, s1.elementsAtIndex(1));
+    EXPECT_EQ(0, s1.elementsAtIndex(160));
+    EXPECT_TRUE(s1.isElementAtIndex(1, 1));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i * 160);
+    }
+    EXPECT_EQ(101, s1.size());
+    EXPECT_EQ(100, s1.elementsAtIndex(0));
+    EXPECT_EQ(0, s1.elementsAtIndex(160));
+}
+
+
+TEST(HashSet_Tests, canBeBuiltFromARange)
+{
+    std::vector<int> unique{5, 3, 9, 1, 7};
+    HashSet<int> s1{unique.begin(), unique.end(), identityHash, true};
+
+    std::vector<int> duplicated{5, 3, 5, 3, 5};
+    HashSet<int> s2{duplicated.begin(), duplicated.end(), identityHash};
+
+    EXPECT_EQ(5, s1.size());
+    for (int i : unique)
+    {
+        EXPECT_TRUE(s1.contains(i));
+    }
+    EXPECT_FALSE(s1.contains(2));
+
+    EXPECT_EQ(2, s2.size());
+    EXPECT_TRUE(s2.contains(5));
+    EXPECT_TRUE(s2.contains(3));
+}
+
+
+TEST(HashSet_Tests, rangesAreAddedIntoOneArrayOfTheRightSize)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 100; ++i)
+    {
+        elements.push_back(i);
+    }
+
+    // 10 * 2^4 = 160 is the first doubling with room for 100 at 0.8.
+    HashSet<int> s1{elements.begin(), elements.end(), identityHash, true};
+    HashSetStats stats = s1.stats();
+    EXPECT_EQ(160, stats.buckets);
+    EXPECT_EQ(100, stats.elements);
+    EXPECT_EQ(0, stats.resizes);
+
+    HashSet<int> s2{elements.begin(), elements.end(), identityHash, false, true};
+    EXPECT_EQ(160, s2.stats().buckets);
+    EXPECT_EQ(0, s2.stats().resizes);
+    for (int i = 100; i < 129; ++i)
+    {
+        s2.add(i);
+    }
+    EXPECT_TRUE(s2.isResizing());
+    EXPECT_EQ(129, s2.size());
+}
+
+
+TEST(HashSet_Tests, statsDescribeTheShapeOfTheTable)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i % 4); }};
+    for (int i = 0; i < 7; ++i)
+    {
+        s1.add(i);
+    }
+
+    HashSetStats stats = s1.stats();
+    EXPECT_EQ(10, stats.buckets);
+    EXPECT_EQ(7, stats.elements);
+    EXPECT_DOUBLE_EQ(0.7, stats.loadFactor);
+    EXPECT_EQ(2, stats.maxChainLength);
+    ASSERT_EQ(3, stats.chainLengthHistogram.size());
+    EXPECT_EQ(6, stats.chainLengthHistogram[0]);
+    EXPECT_EQ(1, stats.chainLengthHistogram[1]);
+    EXPECT_EQ(3, stats.chainLengthHistogram[2]);
+    EXPECT_EQ(0, stats.resizes);
+
+    s1.add(7);
+    s1.add(8);
+    EXPECT_EQ(1, s1.stats().resizes);
+}
+
+
+TEST(HashSet_Tests, statsCountProbesOnlyWhenAsked)
+{
+    HashSet<int> s1{[](const int&) { return 0u; }};
+    s1.add(1);
+    s1.add(2);
+    s1.add(3);
+
+    s1.contains(1);
+    EXPECT_EQ(0, s1.stats().successfulLookups);
+
+    s1.collectLookupStats(true);
+    s1.contains(1);
+    s1.contains(3);
+    s1.contains(4);
+
+    HashSetStats stats = s1.stats();
+    EXPECT_EQ(2, stats.successfulLookups);
+    EXPECT_EQ(1, stats.unsuccessfulLookups);
+    EXPECT_DOUBLE_EQ(2.0, stats.averageSuccessfulProbes);
+    EXPECT_DOUBLE_EQ(3.0, stats.averageUnsuccessfulProbes);
+
+    s1.resetStats();
+    EXPECT_EQ(0, s1.stats().successfulLookups);
+}
+
+
+TEST(HashSet_Tests, canUseAHasherType)
+{
+    HashSet<std::string, WyStringHash> s1{WyStringHash{}};
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    EXPECT_EQ(1000, s1.size());
+    EXPECT_TRUE(s1.contains("999"));
+    EXPECT_FALSE(s1.contains("1000"));
+
+    std::string_view text = "123 4567";
+    EXPECT_TRUE(s1.containsKey(text.substr(0, 3)));
+    EXPECT_FALSE(s1.containsKey(text.substr(4, 4)));
+
+    HashSet<std::string, WyStringHash> s2{s1};
+    HashSet<std::string, WyStringHash> s3{std::move(s1)};
+    EXPECT_TRUE(s2.contains("500"));
+    EXPECT_TRUE(s3.contains("500"));
+    EXPECT_LE(s3.stats().maxChainLength, 8);
+}
@@ -0,0 +1,91 @@
+// NodePool_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for NodePool.
+
+#include <string>
+#include <gtest/gtest.h>
+#include "NodePool.hpp"
+
+
+namespace
+{
+    struct IntNode
+    {
+        int value;
+        IntNode* next;
+    };
+
+
+    struct StringNode
+    {
+        std::string value;
+        StringNode* next;
+    };
+}
+
+
+TEST(NodePool_Tests, nodesComeFromFewChunks)
+{
+    NodePool<IntNode> pool;
+    IntNode* previous = nullptr;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        previous = pool.create(i, previous);
+    }
+
+    // 32 + 64 + 128 + 256 + 512 < 1000 <= 32 + ... + 1024
+    EXPECT_EQ(6, pool.chunkCount());
+
+    int expected = 999;
+    for (IntNode* n = previous; n != nullptr; n = n->next)
+    {
+        EXPECT_EQ(expected--, n->value);
+    }
+    EXPECT_EQ(-1, expected);
+}
+
+
+TEST(NodePool_Tests, destroyedNodesAreReused)
+{
+    NodePool<StringNode> pool;
+    StringNode* a = pool.create("HELLO", nullptr);
+    pool.destroy(a);
+
+    StringNode* b = pool.create("THERE", nullptr);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ("THERE", b->value);
+    pool.destroy(b);
+}
+
+
+TEST(NodePool_Tests, releaseGivesBackEveryChunk)
+{
+    NodePool<IntNode> pool;
+    for (int i = 0; i < 100; ++i)
+    {
+        pool.create(i, nullptr);
+    }
+
+    pool.release();
+    EXPECT_EQ(0, pool.chunkCount());
+
+    IntNode* n = pool.create(1, nullptr);
+    EXPECT_EQ(1, n->value);
+    EXPECT_EQ(1, pool.chunkCount());
+}
+
+
+TEST(NodePool_Tests, movedPoolOwnsTheNodes)
+{
+    NodePool<IntNode> pool;
+    IntNode* n = pool.create(5, nullptr);
+
+    NodePool<IntNode> other{std::move(pool)};
+    EXPECT_EQ(0, pool.chunkCount());
+    EXPECT_EQ(1, other.chunkCount());
+    EXPECT_EQ(5, n->value);
+}
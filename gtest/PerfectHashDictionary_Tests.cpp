@@ -0,0 +1,187 @@
+// PerfectHashDictionary_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PerfectHashDictionary, which build their dictionary files
+// in Google Test's temporary directory.
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "PerfectHashDictionary.hpp"
+
+
+namespace
+{
+    std::string tempPath(const std::string& name)
+    {
+        return testing::TempDir() + name;
+    }
+}
+
+
+TEST(PerfectHashDictionary_Tests, containsExactlyTheWordsItWasBuiltFrom)
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 20000; ++i)
+    {
+        words.push_back("w" + std::to_string(i * 7));
+    }
+    words.push_back("w0");
+
+    std::string path = tempPath("containsExactly.mph");
+    writePerfectHashDictionary(words, path);
+    PerfectHashDictionary dictionary{path};
+    Set<std::string>& set = dictionary;
+
+    EXPECT_EQ(20000, set.size());
+    for (int i = 0; i < 20000; ++i)
+    {
+        ASSERT_TRUE(set.contains("w" + std::to_string(i * 7)));
+        ASSERT_FALSE(set.contains("w" + std::to_string(i * 7 + 1)));
+    }
+    EXPECT_FALSE(set.contains(""));
+    EXPECT_FALSE(dictionary.containsKey("w"));
+    EXPECT_TRUE(dictionary.containsKey(std::string_view{"w14 w21"}.substr(0, 3)));
+}
+
+
+TEST(PerfectHashDictionary_Tests, emptyDictionaryContainsNothing)
+{
+    std::string path = tempPath("empty.mph");
+    writePerfectHashDictionary({}, path);
+    PerfectHashDictionary dictionary{path};
+
+    EXPECT_EQ(0, dictionary.size());
+    EXPECT_FALSE(dictionary.contains(""));
+    EXPECT_FALSE(dictionary.contains("HELLO"));
+}
+
+
+TEST(PerfectHashDictionary_Tests, copiesAndMovesShareTheFile)
+{
+    std::string path = tempPath("copies.mph");
+    writePerfectHashDictionary({"HELLO", "THERE", "BOO"}, path);
+
+    PerfectHashDictionary d1{path};
+    PerfectHashDictionary d2{d1};
+    PerfectHashDictionary d3{std::move(d1)};
+
+    EXPECT_TRUE(d2.contains("THERE"));
+    EXPECT_TRUE(d3.contains("BOO"));
+    EXPECT_EQ(0, d1.size());
+    EXPECT_FALSE(d1.contains("BOO"));
+}
+
+
+TEST(PerfectHashDictionary_Tests, isReadOnly)
+{
+    std::string path = tempPath("readOnly.mph");
+    writePerfectHashDictionary({"HELLO"}, path);
+    PerfectHashDictionary dictionary{path};
+
+    EXPECT_THROW(dictionary.add("THERE"), PerfectHashDictionaryException);
+    EXPECT_FALSE(dictionary.contains("THERE"));
+}
+
+
+TEST(PerfectHashDictionary_Tests, rejectsFilesThatAreNotDictionaries)
+{
+    std::string path = tempPath("notADictionary.mph");
+    {
+        std::ofstream out{path};
+        out << "this is just a word list, not a dictionary file\n";
+    }
+
+    EXPECT_THROW(PerfectHashDictionary{path}, PerfectHashDictionaryException);
+    EXPECT_THROW(PerfectHashDictionary{tempPath("doesNotExist.mph")}, PerfectHashDictionaryException);
+}
+
+
+TEST(PerfectHashDictionary_Tests, rewritingAFileLeavesOpenDictionariesIntact)
+{
+    std::string path = tempPath("rewritten.mph");
+    std::vector<std::string> before;
+    for (int i = 0; i < 5000; ++i)
+    {
+        before.push_back("before" + std::to_string(i));
+    }
+    writePerfectHashDictionary(before, path);
+    PerfectHashDictionary d1{path};
+
+    writePerfectHashDictionary({"after"}, path);
+    PerfectHashDictionary d2{path};
+
+    EXPECT_EQ(5000, d1.size());
+    for (const std::string& word : before)
+    {
+        ASSERT_TRUE(d1.contains(word));
+    }
+    EXPECT_FALSE(d1.contains("after"));
+    EXPECT_EQ(1, d2.size());
+    EXPECT_TRUE(d2.contains("after"));
+    EXPECT_FALSE(d2.contains("before0"));
+}
+
+
+TEST(PerfectHashDictionary_Tests, corruptOffsetsMakeWordsMissInsteadOfReadingPastTheBlob)
+{
+    std::vector<std::string> words{"HELLO", "THERE", "BOO", "AND", "MORE"};
+    std::string path = tempPath("corruptOffsets.mph");
+    writePerfectHashDictionary(words, path);
+
+    std::string contents;
+    {
+        std::ifstream in{path, std::ios::binary};
+        contents.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+    }
+
+    // The header is 32 bytes, with the number of buckets at byte 20; the
+    // offsets follow the header and one pilot per bucket.
+    std::uint32_t bucketCount;
+    std::memcpy(&bucketCount, contents.data() + 20, sizeof(bucketCount));
+    std::size_t offsetsStart = 32 + 4 * bucketCount;
+
+    // Slot 1 now ends past the blob, and slot 2 starts after it ends.
+    std::string decreasing = contents;
+    std::uint32_t huge = 0xFFFFFFF0u;
+    std::memcpy(&decreasing[offsetsStart + 4 * 2], &huge, sizeof(huge));
+
+    // The last word in the blob is now one character short.
+    std::string shortBlob = contents;
+    std::uint32_t last;
+    std::memcpy(&last, contents.data() + offsetsStart + 4 * 5, sizeof(last));
+    last -= 1;
+    std::memcpy(&shortBlob[offsetsStart + 4 * 5], &last, sizeof(last));
+
+    std::pair<std::string, int> cases[] = {{decreasing, 3}, {shortBlob, 4}};
+    for (const auto& [corrupt, expectedFound] : cases)
+    {
+        {
+            std::ofstream out{path, std::ios::binary | std::ios::trunc};
+            out << corrupt;
+        }
+        PerfectHashDictionary dictionary{path};
+        int found = 0;
+        for (const std::string& word : words)
+        {
+            if (dictionary.contains(word))
+            {
+                ++found;
+            }
+        }
+        EXPECT_EQ(expectedFound, found);
+    }
+
+    {
+        std::ofstream out{path, std::ios::binary | std::ios::trunc};
+        out << contents.substr(0, contents.size() - 1);
+    }
+    EXPECT_THROW(PerfectHashDictionary{path}, PerfectHashDictionaryException);
+}
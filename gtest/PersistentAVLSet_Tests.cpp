@@ -0,0 +1,98 @@
+// PersistentAVLSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PersistentAVLSet, including one that reads snapshots on
+// other threads while the set keeps changing.
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "PersistentAVLSet.hpp"
+
+
+TEST(PersistentAVLSet_Tests, behavesLikeABalancedSet)
+{
+    PersistentAVLSet<int> s1;
+    Set<int>& ss1 = s1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        ss1.add((i * 7919) % 20000);
+        ss1.add((i * 7919) % 20000);
+    }
+
+    EXPECT_TRUE(ss1.isImplemented());
+    EXPECT_EQ(20000, ss1.size());
+    EXPECT_LE(s1.height(), 20);
+
+    int expected = 0;
+    s1.inorder([&](const int& i) { EXPECT_EQ(expected++, i); });
+    EXPECT_EQ(20000, expected);
+}
+
+
+TEST(PersistentAVLSet_Tests, snapshotsDoNotSeeLaterAdds)
+{
+    PersistentAVLSet<std::string> s1;
+    std::vector<PersistentAVLSet<std::string>> versions;
+    for (int i = 0; i < 100; ++i)
+    {
+        versions.push_back(s1.snapshot());
+        s1.add(std::to_string(i));
+    }
+
+    for (int v = 0; v < 100; ++v)
+    {
+        ASSERT_EQ(static_cast<unsigned int>(v), versions[v].size());
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_EQ(i < v, versions[v].contains(std::to_string(i)));
+        }
+    }
+
+    PersistentAVLSet<std::string> s2{versions[50]};
+    s2.add("HELLO");
+    versions[50] = std::move(s2);
+    EXPECT_EQ(51, versions[50].size());
+    EXPECT_FALSE(versions[51].contains("HELLO"));
+    EXPECT_FALSE(s1.contains("HELLO"));
+}
+
+
+TEST(PersistentAVLSet_Tests, snapshotsCanBeReadOnOtherThreads)
+{
+    PersistentAVLSet<int> s1;
+    std::vector<std::thread> readers;
+    std::vector<int> found(8, 0);
+
+    for (int r = 0; r < 8; ++r)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            s1.add(r * 1000 + i);
+        }
+
+        readers.emplace_back([snapshot = s1.snapshot(), &found, r]()
+        {
+            for (int i = 0; i < 8000; ++i)
+            {
+                if (snapshot.contains(i))
+                {
+                    ++found[r];
+                }
+            }
+        });
+    }
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    for (int r = 0; r < 8; ++r)
+    {
+        EXPECT_EQ((r + 1) * 1000, found[r]);
+    }
+}
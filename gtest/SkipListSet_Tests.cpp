@@ -0,0 +1,405 @@
+// SkipListSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for SkipListSet, beyond the sanity checks, including searches
+// in orders that move a Finger forward, backward, and all over.
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "SkipListSet.hpp"
+
+
+namespace
+{
+    template <typename ElementType>
+    class AlwaysGrowLevelTester : public SkipListLevelTester<ElementType>
+    {
+    public:
+        virtual bool shouldOccupyNextLevel(const ElementType&) override
+        {
+            return true;
+        }
+
+        virtual std::unique_ptr<SkipListLevelTester<ElementType>> clone() override
+        {
+            return std::make_unique<AlwaysGrowLevelTester<ElementType>>();
+        }
+    };
+}
+
+
+TEST(SkipListSet_Tests, containsEverythingAddedInAnyOrder)
+{
+    SkipListSet<int> s1;
+    Set<int>& ss1 = s1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        ss1.add((i * 7919) % 20000 * 2);
+        ss1.add((i * 7919) % 20000 * 2);
+    }
+
+    EXPECT_TRUE(ss1.isImplemented());
+    EXPECT_EQ(20000, ss1.size());
+    EXPECT_EQ(20000, s1.elementsOnLevel(0));
+    EXPECT_LT(s1.elementsOnLevel(1), 20000);
+    EXPECT_EQ(0, s1.elementsOnLevel(s1.levelCount()));
+
+    for (int i = 0; i < 40000; ++i)
+    {
+        ASSERT_EQ(i % 2 == 0, ss1.contains(i));
+    }
+    for (int i = 39999; i >= 0; --i)
+    {
+        ASSERT_EQ(i % 2 == 0, ss1.contains(i));
+    }
+    for (int i = 0; i < 40000; ++i)
+    {
+        int key = static_cast<int>((i * 2654435761u) % 40001) - 1;
+        ASSERT_EQ(key >= 0 && key % 2 == 0, ss1.contains(key));
+    }
+}
+
+
+TEST(SkipListSet_Tests, fingerSearchesFindEverythingInAnyOrder)
+{
+    SkipListSet<int> s1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        s1.add((i * 7919) % 20000 * 2);
+    }
+
+    SkipListSet<int>::Finger f = s1.finger();
+    for (int i = 0; i < 40000; ++i)
+    {
+        ASSERT_EQ(i % 2 == 0, s1.containsFrom(f, i));
+    }
+    for (int i = 39999; i >= 0; --i)
+    {
+        ASSERT_EQ(i % 2 == 0, s1.containsFrom(f, i));
+    }
+    for (int i = 0; i < 40000; ++i)
+    {
+        int key = static_cast<int>((i * 2654435761u) % 40001) - 1;
+        ASSERT_EQ(key >= 0 && key % 2 == 0, s1.containsFrom(f, key));
+    }
+}
+
+
+TEST(SkipListSet_Tests, fingersSurviveAddsAroundThem)
+{
+    SkipListSet<int> s1{std::make_unique<AlwaysGrowLevelTester<int>>()};
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i * 10);
+    }
+
+    SkipListSet<int>::Finger f = s1.finger();
+    EXPECT_TRUE(s1.containsFrom(f, 500));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i * 10 + 5);
+    }
+
+    for (int i = 999; i >= 0; --i)
+    {
+        ASSERT_EQ(i % 5 == 0, s1.containsFrom(f, i));
+        if (i % 100 == 3)
+        {
+            s1.add(i);
+            ASSERT_TRUE(s1.containsFrom(f, i));
+        }
+    }
+}
+
+
+TEST(SkipListSet_Tests, fingersFromOtherSetsAreStartedOver)
+{
+    SkipListSet<int> s1;
+    SkipListSet<int> s2;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i * 2);
+        s2.add(i * 2 + 1);
+    }
+
+    SkipListSet<int>::Finger f = s1.finger();
+    EXPECT_TRUE(s1.containsFrom(f, 1000));
+    EXPECT_FALSE(s2.containsFrom(f, 1000));
+    EXPECT_TRUE(s2.containsFrom(f, 1001));
+    EXPECT_FALSE(s1.containsFrom(f, 1001));
+}
+
+
+TEST(SkipListSet_Tests, threadsCanSearchAtTheSameTime)
+{
+    SkipListSet<int> s1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        s1.add(i * 2);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> found(4, 0);
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&s1, &found, t]()
+        {
+            SkipListSet<int>::Finger f = s1.finger();
+            for (int i = 0; i < 40000; ++i)
+            {
+                if (t % 2 == 0 ? s1.contains(i) : s1.containsFrom(f, i))
+                {
+                    ++found[t];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(std::vector<int>(4, 20000), found);
+}
+
+
+TEST(SkipListSet_Tests, searchesBeyondEitherEndAreMisses)
+{
+    SkipListSet<int> s1;
+    for (int i = 10; i < 20; ++i)
+    {
+        s1.add(i);
+    }
+
+    EXPECT_TRUE(s1.contains(19));
+    EXPECT_FALSE(s1.contains(100));
+    EXPECT_FALSE(s1.contains(-100));
+    EXPECT_TRUE(s1.contains(10));
+    EXPECT_FALSE(s1.contains(9));
+    EXPECT_FALSE(s1.contains(20));
+
+    s1.add(5);
+    s1.add(25);
+    EXPECT_TRUE(s1.contains(5));
+    EXPECT_TRUE(s1.contains(25));
+    EXPECT_EQ(12, s1.size());
+}
+
+
+TEST(SkipListSet_Tests, elementsGrowAtMostOneLevelAboveTheTop)
+{
+    SkipListSet<int> s1{std::make_unique<AlwaysGrowLevelTester<int>>()};
+    for (int i = 0; i < 5; ++i)
+    {
+        s1.add(i);
+    }
+
+    EXPECT_EQ(6, s1.levelCount());
+    EXPECT_EQ(5, s1.elementsOnLevel(0));
+    for (unsigned int level = 1; level < 6; ++level)
+    {
+        EXPECT_EQ(6 - level, s1.elementsOnLevel(level));
+    }
+
+    EXPECT_TRUE(s1.isElementOnLevel(4, 5));
+    EXPECT_FALSE(s1.isElementOnLevel(3, 5));
+    EXPECT_TRUE(s1.isElementOnLevel(3, 4));
+    EXPECT_TRUE(s1.isElementOnLevel(0, 1));
+    EXPECT_FALSE(s1.isElementOnLevel(0, 2));
+    EXPECT_FALSE(s1.isElementOnLevel(0, 6));
+    EXPECT_FALSE(s1.isElementOnLevel(7, 0));
+}
+
+
+TEST(SkipListSet_Tests, copiesKeepEveryElementOnItsLevels)
+{
+    SkipListSet<std::string> s1;
+    for (int i = 0; i < 2000; ++i)
+    {
+        s1.add(std::to_string(i * 7));
+    }
+
+    SkipListSet<std::string> s2{s1};
+    s2.add("HELLO");
+    EXPECT_EQ(2000, s1.size());
+    EXPECT_EQ(2001, s2.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+    EXPECT_TRUE(s2.contains("HELLO"));
+
+    for (unsigned int level = 0; level < s1.levelCount(); ++level)
+    {
+        for (int i = 0; i < 2000; i += 13)
+        {
+            std::string element = std::to_string(i * 7);
+            ASSERT_EQ(s1.isElementOnLevel(element, level), s2.isElementOnLevel(element, level));
+        }
+    }
+
+    SkipListSet<std::string> s3;
+    s3.add("BOO");
+    s3 = s1;
+    EXPECT_FALSE(s3.contains("BOO"));
+    EXPECT_EQ(s1.levelCount(), s3.levelCount());
+    for (unsigned int level = 0; level < s1.levelCount(); ++level)
+    {
+        EXPECT_EQ(s1.elementsOnLevel(level), s3.elementsOnLevel(level));
+    }
+}
+
+
+TEST(SkipListSet_Tests, movedFromSetsCanStillBeUsed)
+{
+    SkipListSet<std::string> s1;
+    s1.add("A");
+    s1.add("B");
+
+    SkipListSet<std::string> s2{std::move(s1)};
+    EXPECT_EQ(2, s2.size());
+    EXPECT_TRUE(s2.contains("B"));
+
+    s1 = std::move(s2);
+    EXPECT_TRUE(s1.contains("A"));
+
+    SkipListSet<std::string> s3{std::move(s1)};
+    EXPECT_EQ(0, s1.size());
+    EXPECT_FALSE(s1.contains("A"));
+    s1.add("C");
+    EXPECT_TRUE(s1.contains("C"));
+    EXPECT_EQ(1, s1.levelCount());
+}
+
+
+TEST(SkipListSet_Tests, buildFromSortedPlacesEveryPowerOfTwo)
+{
+    std::vector<int> elements;
+    for (int i = 1; i <= 1000; ++i)
+    {
+        elements.push_back(i * 3);
+    }
+
+    SkipListSet<int> s1 = SkipListSet<int>::buildFromSorted(elements.begin(), elements.end());
+    EXPECT_EQ(1000, s1.size());
+    EXPECT_EQ(10, s1.levelCount());
+    for (unsigned int level = 0; level < 10; ++level)
+    {
+        EXPECT_EQ(1000u >> level, s1.elementsOnLevel(level));
+    }
+
+    EXPECT_TRUE(s1.isElementOnLevel(512 * 3, 9));
+    EXPECT_TRUE(s1.isElementOnLevel(12 * 3, 2));
+    EXPECT_FALSE(s1.isElementOnLevel(12 * 3, 3));
+    EXPECT_FALSE(s1.isElementOnLevel(7 * 3, 1));
+
+    for (int i = 0; i <= 3001; ++i)
+    {
+        ASSERT_EQ(i > 0 && i % 3 == 0, s1.contains(i));
+    }
+    for (int i = 3001; i >= 0; --i)
+    {
+        ASSERT_EQ(i > 0 && i % 3 == 0, s1.contains(i));
+    }
+
+    s1.add(3001);
+    s1.add(1);
+    s1.add(3);
+    EXPECT_EQ(1002, s1.size());
+    EXPECT_TRUE(s1.contains(3001));
+    EXPECT_TRUE(s1.contains(1));
+}
+
+
+TEST(SkipListSet_Tests, buildFromSortedWithNothingIsEmpty)
+{
+    std::vector<std::string> none;
+    SkipListSet<std::string> s1 = SkipListSet<std::string>::buildFromSorted(
+        none.begin(), none.end(), std::make_unique<AlwaysGrowLevelTester<std::string>>());
+
+    EXPECT_EQ(0, s1.size());
+    EXPECT_EQ(1, s1.levelCount());
+    EXPECT_FALSE(s1.contains("A"));
+
+    s1.add("A");
+    EXPECT_EQ(2, s1.levelCount());
+    EXPECT_TRUE(s1.isElementOnLevel("A", 1));
+}
+
+
+TEST(SkipListSet_Tests, geometricLevelTestersChooseHeightsWithTheRightOdds)
+{
+    constexpr int draws = 100000;
+
+    for (unsigned int oneIn : {2u, 4u})
+    {
+        GeometricSkipListLevelTester<int> tester{oneIn};
+        int atLeastTwo = 0;
+        int atLeastThree = 0;
+        int occupied = 0;
+        for (int i = 0; i < draws; ++i)
+        {
+            unsigned int levels = tester.levelsToOccupy(i, 64);
+            ASSERT_GE(levels, 1);
+            atLeastTwo += levels >= 2 ? 1 : 0;
+            atLeastThree += levels >= 3 ? 1 : 0;
+            occupied += tester.shouldOccupyNextLevel(i) ? 1 : 0;
+        }
+
+        double p = 1.0 / oneIn;
+        EXPECT_NEAR(p, 1.0 * atLeastTwo / draws, 0.01);
+        EXPECT_NEAR(p * p, 1.0 * atLeastThree / draws, 0.01);
+        EXPECT_NEAR(p, 1.0 * occupied / draws, 0.01);
+    }
+}
+
+
+TEST(SkipListSet_Tests, levelsToOccupyNeverExceedsTheLimit)
+{
+    GeometricSkipListLevelTester<int> geometric;
+    AlwaysGrowLevelTester<int> alwaysGrow;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(1, geometric.levelsToOccupy(i, 1));
+        ASSERT_LE(geometric.levelsToOccupy(i, 3), 3);
+    }
+    EXPECT_EQ(7, alwaysGrow.levelsToOccupy(0, 7));
+
+    std::unique_ptr<SkipListLevelTester<int>> copy = geometric.clone();
+    EXPECT_EQ(1, copy->levelsToOccupy(0, 1));
+}
+
+
+TEST(SkipListSet_Tests, geometricLevelTestersRejectOddsThatArentPowersOfTwo)
+{
+    EXPECT_THROW(GeometricSkipListLevelTester<int>{0}, std::invalid_argument);
+    EXPECT_THROW(GeometricSkipListLevelTester<int>{1}, std::invalid_argument);
+    EXPECT_THROW(GeometricSkipListLevelTester<int>{3}, std::invalid_argument);
+    EXPECT_THROW(GeometricSkipListLevelTester<int>{6}, std::invalid_argument);
+    EXPECT_THROW(GeometricSkipListLevelTester<int>{0xFFFFFFFFu}, std::invalid_argument);
+    EXPECT_NO_THROW(GeometricSkipListLevelTester<int>{8});
+    EXPECT_NO_THROW(GeometricSkipListLevelTester<int>{0x80000000u});
+}
+
+
+TEST(SkipListSet_Tests, quarterProbabilityListsAreShorter)
+{
+    SkipListSet<int> s1{std::make_unique<GeometricSkipListLevelTester<int>>(4)};
+    for (int i = 0; i < 20000; ++i)
+    {
+        s1.add((i * 7919) % 20000);
+    }
+
+    EXPECT_EQ(20000, s1.size());
+    EXPECT_NEAR(5000, s1.elementsOnLevel(1), 500);
+    EXPECT_LE(s1.levelCount(), 12);
+    for (int i = 0; i < 20000; ++i)
+    {
+        ASSERT_TRUE(s1.contains(i));
+    }
+}
@@ -0,0 +1,93 @@
+// StringHashers_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the string hashers.
+
+#include <set>
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+#include "StringHashers.hpp"
+
+
+namespace
+{
+    // Hashes every prefix of a long string (so that every length from 0
+    // to 200 is covered) and returns the number of distinct hashes.
+    template <typename Hash>
+    unsigned int distinctPrefixHashes(Hash hash)
+    {
+        std::string text;
+        for (int i = 0; i < 200; ++i)
+        {
+            text += static_cast<char>('a' + (i * 7) % 26);
+        }
+
+        std::set<std::uint64_t> hashes;
+        for (std::size_t length = 0; length <= text.size(); ++length)
+        {
+            hashes.insert(hash(std::string_view{text}.substr(0, length)));
+        }
+        return hashes.size();
+    }
+}
+
+
+TEST(StringHashers_Tests, wyHashIsDeterministicAndSeeded)
+{
+    WyStringHash h1;
+    WyStringHash h2;
+    WyStringHash seeded{12345};
+
+    EXPECT_EQ(h1("HELLO"), h2(std::string{"HELLO"}));
+    EXPECT_NE(h1("HELLO"), h1("HELLP"));
+    EXPECT_NE(h1("HELLO"), seeded("HELLO"));
+}
+
+
+TEST(StringHashers_Tests, wyHashDistinguishesEveryLength)
+{
+    EXPECT_EQ(201, distinctPrefixHashes(WyStringHash{}));
+}
+
+
+#if defined(__SSE4_2__)
+
+TEST(StringHashers_Tests, crc32HashDistinguishesEveryLength)
+{
+    Crc32StringHash h;
+    EXPECT_EQ(h("HELLO"), h(std::string{"HELLO"}));
+    EXPECT_EQ(201, distinctPrefixHashes(h));
+}
+
+
+TEST(StringHashers_Tests, crc32HashUpperHalfIsNotAFunctionOfTheLowerHalf)
+{
+    Crc32StringHash h;
+    std::set<std::uint64_t> differences;
+    unsigned int upperBitsSet[32] = {};
+    constexpr unsigned int count = 2000;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        std::string s = "word" + std::to_string(10000000 + i * 7919);
+        std::uint64_t hash = h(s);
+        std::uint64_t lower = hash & 0xFFFFFFFFu;
+        std::uint64_t upper = hash >> 32;
+        differences.insert(upper ^ lower);
+        for (unsigned int bit = 0; bit < 32; ++bit)
+        {
+            upperBitsSet[bit] += (upper >> bit) & 1;
+        }
+    }
+
+    EXPECT_GT(differences.size(), count - 10);
+    for (unsigned int bit = 0; bit < 32; ++bit)
+    {
+        EXPECT_NEAR(count / 2, upperBitsSet[bit], count / 10);
+    }
+}
+
+#endif
@@ -0,0 +1,128 @@
+// UnrolledSkipListSet_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for UnrolledSkipListSet.  Most of them use tiny blocks, so
+// that blocks fill up and split often.
+
+#include <string>
+#include <utility>
+#include <gtest/gtest.h>
+#include "UnrolledSkipListSet.hpp"
+
+
+TEST(UnrolledSkipListSet_Tests, containsEverythingAddedInAnyOrder)
+{
+    UnrolledSkipListSet<int, 4> s1;
+    Set<int>& ss1 = s1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        ss1.add((i * 7919) % 20000 * 2);
+        ss1.add((i * 7919) % 20000 * 2);
+    }
+
+    EXPECT_TRUE(ss1.isImplemented());
+    EXPECT_EQ(20000, ss1.size());
+    for (int i = -1; i < 40000; ++i)
+    {
+        ASSERT_EQ(i >= 0 && i % 2 == 0, ss1.contains(i));
+    }
+}
+
+
+TEST(UnrolledSkipListSet_Tests, ascendingAndDescendingAddsSplitBlocks)
+{
+    UnrolledSkipListSet<std::string, 4> s1;
+    UnrolledSkipListSet<std::string, 4> s2;
+    for (int i = 0; i < 3000; ++i)
+    {
+        s1.add(std::to_string(100000 + i));
+        s2.add(std::to_string(100000 + 2999 - i));
+    }
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        ASSERT_TRUE(s1.contains(std::to_string(100000 + i)));
+        ASSERT_TRUE(s2.contains(std::to_string(100000 + i)));
+    }
+    EXPECT_FALSE(s1.contains("0"));
+    EXPECT_FALSE(s2.contains("2"));
+    EXPECT_EQ(3000, s1.size());
+    EXPECT_EQ(3000, s2.size());
+}
+
+
+TEST(UnrolledSkipListSet_Tests, levelsShrinkByAboutTheFanout)
+{
+    UnrolledSkipListSet<int> s1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        s1.add((i * 7919) % 100000);
+    }
+
+    EXPECT_EQ(100000, s1.elementsOnLevel(0));
+    EXPECT_GE(s1.blocksOnLevel(0), 100000 / s1.BLOCK_CAPACITY);
+    EXPECT_LE(s1.blocksOnLevel(0), 100000 / s1.FANOUT * 2);
+    EXPECT_LE(s1.levelCount(), 6);
+    EXPECT_EQ(0, s1.elementsOnLevel(s1.levelCount()));
+    EXPECT_EQ(0, s1.blocksOnLevel(s1.levelCount()));
+
+    for (unsigned int level = 1; level < s1.levelCount(); ++level)
+    {
+        EXPECT_LT(s1.elementsOnLevel(level), s1.elementsOnLevel(level - 1));
+    }
+
+    unsigned int onLevel1 = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (s1.isElementOnLevel(i, 1))
+        {
+            ASSERT_TRUE(s1.isElementOnLevel(i, 0));
+            ++onLevel1;
+        }
+    }
+    EXPECT_EQ(s1.elementsOnLevel(1), onLevel1);
+}
+
+
+TEST(UnrolledSkipListSet_Tests, copiesKeepEveryElementOnItsLevels)
+{
+    UnrolledSkipListSet<std::string, 4> s1;
+    for (int i = 0; i < 2000; ++i)
+    {
+        s1.add(std::to_string(i * 7));
+    }
+
+    UnrolledSkipListSet<std::string, 4> s2{s1};
+    s2.add("HELLO");
+    EXPECT_EQ(2000, s1.size());
+    EXPECT_EQ(2001, s2.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+    EXPECT_TRUE(s2.contains("HELLO"));
+
+    for (unsigned int level = 0; level < s1.levelCount(); ++level)
+    {
+        for (int i = 0; i < 2000; i += 13)
+        {
+            std::string element = std::to_string(i * 7);
+            ASSERT_EQ(s1.isElementOnLevel(element, level), s2.isElementOnLevel(element, level));
+        }
+    }
+
+    UnrolledSkipListSet<std::string, 4> s3;
+    s3.add("BOO");
+    s3 = s1;
+    EXPECT_FALSE(s3.contains("BOO"));
+    for (unsigned int level = 0; level < s1.levelCount(); ++level)
+    {
+        EXPECT_EQ(s1.elementsOnLevel(level), s3.elementsOnLevel(level));
+        EXPECT_EQ(s1.blocksOnLevel(level), s3.blocksOnLevel(level));
+    }
+
+    UnrolledSkipListSet<std::string, 4> s4{std::move(s3)};
+    EXPECT_EQ(2000, s4.size());
+    EXPECT_EQ(0, s3.size());
+    s3.add("A");
+    EXPECT_TRUE(s3.contains("A"));
+}
@@ -0,0 +1,82 @@
+// WordChecker_Tests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests covering each of the five suggestion algorithms of
+// WordChecker.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ListSet.hpp"
+#include "WordChecker.hpp"
+
+
+namespace
+{
+    bool suggested(const std::vector<std::string>& suggestions, const std::string& word)
+    {
+        return std::find(suggestions.begin(), suggestions.end(), word) != suggestions.end();
+    }
+}
+
+
+TEST(WordChecker_Tests, suggestsFromEveryAlgorithm)
+{
+    ListSet<std::string> set;
+    set.add("BACD");     // swapping the first two letters
+    set.add("ABXCD");    // inserting a letter
+    set.add("ACD");      // deleting a letter
+    set.add("ABZD");     // replacing a letter
+    set.add("AB");       // splitting ...
+    set.add("CD");       // ... into two words
+    set.add("ABCDE");    // inserting a letter at the end
+
+    WordChecker checker{set};
+    std::vector<std::string> suggestions = checker.findSuggestions("ABCD");
+
+    EXPECT_TRUE(suggested(suggestions, "BACD"));
+    EXPECT_TRUE(suggested(suggestions, "ABXCD"));
+    EXPECT_TRUE(suggested(suggestions, "ACD"));
+    EXPECT_TRUE(suggested(suggestions, "ABZD"));
+    EXPECT_TRUE(suggested(suggestions, "AB"));
+    EXPECT_TRUE(suggested(suggestions, "CD"));
+    EXPECT_TRUE(suggested(suggestions, "ABCDE"));
+    EXPECT_EQ(7, suggestions.size());
+}
+
+
+TEST(WordChecker_Tests, doesNotRepeatSuggestions)
+{
+    ListSet<std::string> set;
+    set.add("AA");
+    set.add("A");
+
+    WordChecker checker{set};
+    std::vector<std::string> suggestions = checker.findSuggestions("AAA");
+
+    ASSERT_EQ(2, suggestions.size());
+    EXPECT_TRUE(suggested(suggestions, "AA"));
+    EXPECT_TRUE(suggested(suggestions, "A"));
+}
+
+
+TEST(WordChecker_Tests, prefilterDoesNotChangeSuggestions)
+{
+    ListSet<std::string> set;
+    BlockedBloomFilter filter{7};
+    for (const char* word : {"BACD", "ABXCD", "ACD", "ABZD", "AB", "CD", "ABCDE"})
+    {
+        set.add(word);
+        filter.add(word);
+    }
+
+    WordChecker plain{set};
+    WordChecker filtered{set, filter};
+
+    EXPECT_EQ(plain.findSuggestions("ABCD"), filtered.findSuggestions("ABCD"));
+    EXPECT_TRUE(filtered.wordExists("ACD"));
+    EXPECT_FALSE(filtered.wordExists("ABCD"));
+}
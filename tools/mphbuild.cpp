@@ -0,0 +1,53 @@
+// mphbuild.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// mphbuild turns a word list (one word per line) into a dictionary file
+// that can be opened with PerfectHashDictionary:
+//
+//     mphbuild words.txt words.mph
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PerfectHashDictionary.hpp"
+
+
+int main(int argc, char** argv)
+{
+    if(argc != 3) {
+        std::cout << "usage: " << argv[0] << " WORDLIST OUTPUT" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in{argv[1]};
+    if(!in) {
+        std::cout << "ERROR: could not open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> words;
+    std::string line;
+    while(std::getline(in, line)) {
+        if(!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if(!line.empty()) {
+            words.push_back(line);
+        }
+    }
+
+    try {
+        writePerfectHashDictionary(words, argv[2]);
+        PerfectHashDictionary dictionary{argv[2]};
+        std::cout << "wrote " << dictionary.size() << " words to " << argv[2] << std::endl;
+    }
+    catch(PerfectHashDictionaryException& e) {
+        std::cout << "ERROR: " << e.reason() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}